@@ -305,6 +305,10 @@ public:
   bool IsEmpty() const {
     return m_sz <= 0;
   }
+  // Access memory manager (NULL for static array)
+  memory::MMBase* GetMM() const {
+    return C::GetMM();
+  }
   // Expand array at certain position
   // Input: p - the position expand happens
   //        t_sz - expand size
@@ -10,31 +10,99 @@
 
 #include <utility>
 #include <functional>
+#include <algorithm>
+#include <limits>
 #include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_search.h"
 
 namespace jnu {
+// Base of companion search indexes of sorted set
+template<typename S>
+class SetIndex;
+// Options of sorted set (flags)
+const static int ARR_SET_MULTI = 1;  // Equal keys, in insertion order
+const static int ARR_SET_FINGER = 2;  // Search from last location
 // Sorted set
 // Template arguments:
 // C - the array data type (static, dynamic or hybrid)
 // K - the type of key
 // KEY - the function for getting key from underline objects
-// LESS - comparison of key (less than)
+// LESS - comparison of key (less than), a function or a
+//        comparator object, an object may compare keys with
+//        other types of search keys (transparent)
+// OPT - options (ARR_SET_*)
 template<typename C, typename K,
          auto KEY = (const K& (*)(const typename C::Type)) NULL,
-         auto LESS = (bool (*) (const K&, const K&)) NULL>
+         auto LESS = (bool (*) (const K&, const K&)) NULL,
+         int OPT = 0>
 class ArraySetT {
   // Default key comparison if LESS is not defined (NULL)
-  template<decltype(LESS) L>
+  template<decltype(LESS) L, typename A, typename B>
   static typename std::enable_if<L == NULL, bool>::type
-  Compare(const K& a, const K& b) {
-    return a < b;  // Default comparison
+  Compare(const A& a, const B& b) {
+    if constexpr (MIXED<A, B>) {
+      return ExactLess(a, b);  // No exact common type
+    } else {
+      return a < b;  // Default comparison
+    }
   }
   // Use LESS as comparison is it is defined (not NULL)
-  template<decltype(LESS) L>
+  template<decltype(LESS) L, typename A, typename B>
   static typename std::enable_if<L != NULL, bool>::type
-  Compare(const K& a, const K& b) {
-    return L(a, b);  // Use LESS as comparison
+  Compare(const A& a, const B& b) {
+    return (*L)(a, b);  // Use LESS as comparison
   }
+  // Check if keys and Q are comparable by operator <
+  template<typename Q, typename = void>
+  struct Comparable : std::false_type {
+  };
+  template<typename Q>
+  struct Comparable<Q, std::void_t<
+      decltype(std::declval<const K&>() < std::declval<const Q&>()),
+      decltype(std::declval<const Q&>() < std::declval<const K&>())>>
+    : std::true_type {
+  };
+  // Check if every value of arithmetic type A is a value of
+  // arithmetic type B (false for other types)
+  template<typename A, typename B, bool = std::is_arithmetic<A>::value &&
+                                          std::is_arithmetic<B>::value>
+  struct Lossless : std::false_type {
+  };
+  template<typename A, typename B>
+  struct Lossless<A, B, true> : std::integral_constant<bool,
+      std::numeric_limits<A>::digits <= std::numeric_limits<B>::digits &&
+      std::numeric_limits<A>::max_exponent <=
+      std::numeric_limits<B>::max_exponent &&
+      (std::is_unsigned<A>::value || std::is_signed<B>::value) &&
+      (std::is_integral<A>::value || std::is_floating_point<B>::value)> {
+  };
+  // Check if arithmetic types A and B convert to neither one
+  // without loss (signed and unsigned, integer and floating
+  // point), they are compared by ExactLess
+  template<typename A, typename B>
+  static constexpr bool MIXED =
+    std::is_arithmetic<A>::value && std::is_arithmetic<B>::value &&
+    !Lossless<A, B>::value && !Lossless<B, A>::value;
+  // Search keys of type Q are compared with keys directly
+  // (otherwise converted to key type once per search)
+  // Arithmetic search keys are converted if they convert without
+  // loss, for fast search, otherwise they are compared directly
+  // if keys convert to them without loss (by default comparison)
+  // Other arithmetic search keys are converted if their value
+  // is a key value (FitKey), otherwise compared exactly
+  template<typename Q>
+  static constexpr bool TRANSPARENT =
+    !std::is_same<Q, K>::value &&
+    (std::is_arithmetic<Q>::value && std::is_arithmetic<K>::value ?
+     LESS == NULL && Lossless<K, Q>::value &&
+     !Lossless<Q, K>::value :
+     LESS == NULL ? Comparable<Q>::value :
+                    !std::is_function<typename std::remove_pointer<
+                                      decltype(LESS)>::type>::value);
+  // Branchless search for arithmetic keys with default comparison
+  static constexpr bool FAST_SEARCH = std::is_arithmetic<K>::value &&
+                                      LESS == NULL;
   // Default get key function is KEY is not defined (NULL)
   typedef typename C::Type T;  // Underline data type
   template<decltype(KEY) L>
@@ -48,13 +116,34 @@ class ArraySetT {
   GetKey(const T& t) {
     return L(t);  // Use LESS function to get key
   }
+  // Serial stable sort of bulk input
+  struct StableSort {
+    template<typename LT>
+    void operator()(T* first, T* last, LT less) const {
+      std::stable_sort(first, last, less);
+    }
+  };
 public:
   typedef T Type;  // Underline data type
   typedef K Key;  // Key type
   typedef typename C::Alloc Alloc;
+  // Elements are the keys, compared by default operator <
+  static constexpr bool PLAIN_KEY = std::is_same<T, K>::value &&
+                                    KEY == NULL && LESS == NULL;
+  // Equal keys are allowed, a search finds the first one, an
+  // insertion goes after the last one, and replace versions
+  // of insertions insert too
+  static constexpr bool MULTI = OPT & ARR_SET_MULTI;
+  // Searches start from the last located position (finger) and
+  // gallop outward, O(log d) for a key d elements away
+  // Const searches move the finger, so concurrent searches need
+  // a cursor each
+  static constexpr bool FINGER = OPT & ARR_SET_FINGER;
   // Search or insertion result structure
   class Res {
     friend class ArraySetT;
+    template<typename S>
+    friend class SetIndex;
   public:
     // Get underline const iterator
     T* operator*() const {
@@ -86,22 +175,104 @@ public:
     T* m_it;  // Array iterator
     bool m_found;  // Flag for data found
   };
+  // Zero-copy view of continuous elements [begin, end)
+  // The view is invalidated by modification of the set
+  class View {
+    friend class ArraySetT;
+  public:
+    // Begin of view
+    T* Begin() const {
+      return m_begin;
+    }
+    // End of view (not exclusive)
+    T* End() const {
+      return m_end;
+    }
+    // Number of elements in view
+    size_t Size() const {
+      return m_end - m_begin;
+    }
+    // Check if view is empty
+    bool IsEmpty() const {
+      return m_begin == m_end;
+    }
+    // Element of view
+    T& operator[](size_t i) const {
+      return m_begin[i];
+    }
+  private:
+    // Constructor
+    View(T* b, T* e)
+      : m_begin (b),
+        m_end (e) {
+    }
+    T* m_begin;  // Begin of view
+    T* m_end;  // End of view
+  };
+  // Cursor of sequential searches, each search gallops from
+  // the location of the previous one, for any set, and with
+  // no shared state, so each reader may have its own
+  // The cursor is not invalidated by modification of the set,
+  // its position is kept as an offset
+  class Cursor {
+    friend class ArraySetT;
+  public:
+    // Locate key from cursor, and move cursor to the location
+    template<typename Q>
+    Res Locate(const Q& key) {
+      return m_set->LocateFrom(key, m_pos);
+    }
+    // Find key from cursor
+    template<typename Q>
+    T* Find(const Q& key) {
+      Res r = Locate(key);
+      return r.Found() ? *r : NULL;
+    }
+    // First element not less than key, from cursor
+    template<typename Q>
+    T* LowerBound(const Q& key) {
+      return *Locate(key);
+    }
+    // Current position of cursor
+    T* Position() const {
+      return m_set->Begin() + JNU_MIN(m_pos, m_set->Size());
+    }
+  private:
+    // Constructor
+    Cursor(const ArraySetT* s, size_t pos)
+      : m_set (s),
+        m_pos (pos) {
+    }
+    const ArraySetT* m_set;  // Searched set
+    size_t m_pos;  // Offset of last location
+  };
+  // Get key of element
+  static const K& KeyOf(const T& t) {
+    return GetKey<KEY>(t);
+  }
+  // Less comparison of keys
+  static bool KeyLess(const K& a, const K& b) {
+    return Less(a, b);
+  }
   // Set constructor
   // Input: rsv_sz - reserve memory size
   //        mm - memory mamanger (use buildin as default)
   ArraySetT(size_t rsv_sz = 0,
             memory::MMBase* mm = &memory::MM_BUILDIN)
-    : m_data (rsv_sz, mm) {
+    : m_data (rsv_sz, mm),
+      m_finger (0) {
   }
   // Deconstructor
   ~ArraySetT() {
   }
   // Copy constructor
-  ArraySetT(const ArraySetT& s) {
+  ArraySetT(const ArraySetT& s)
+    : m_finger (0) {
     *this = s;
   }
   // Move constructor
-  ArraySetT(ArraySetT&& s) {
+  ArraySetT(ArraySetT&& s)
+    : m_finger (0) {
     *this = std::move(s);
   }
   // Assign operator
@@ -353,6 +524,37 @@ public:
   bool ReplaceInjectSorted(H& arr, T* t, T* t_end, Hints... hints) {
     return ReplaceInjectSorted(arr, t, Distance(t, t_end), hints...);
   }
+  // No replace bulk insert (unsorted) array
+  // Input is copied into a buffer, sorted, duplicated keys
+  // are removed and the result is merged into the set from
+  // the back, existing elements are moved at most once
+  // Much faster than Insert for large input
+  // Input: t, t_sz - input data array
+  //        sort - stable sort of input, called as
+  //               sort(first, last, less), for example a
+  //               parallel sort (jnu_array_set_parallel.h)
+  // Return: true - insert successful
+  template<typename S = StableSort>
+  bool BulkInsert(const T* t, size_t t_sz, S sort = S()) {
+    return Bulk<const T, NoReplace>(t, t_sz, sort);
+  }
+  // Replace bulk insert, for duplicated keys in input the
+  // last one wins
+  template<typename S = StableSort>
+  bool ReplaceBulkInsert(const T* t, size_t t_sz, S sort = S()) {
+    return Bulk<const T, Replace>(t, t_sz, sort);
+  }
+  // No replace bulk inject (unsorted) array
+  // Elements in array will be moved to set
+  template<typename S = StableSort>
+  bool BulkInject(T* t, size_t t_sz, S sort = S()) {
+    return Bulk<T, NoReplace>(t, t_sz, sort);
+  }
+  // Replace bulk inject
+  template<typename S = StableSort>
+  bool ReplaceBulkInject(T* t, size_t t_sz, S sort = S()) {
+    return Bulk<T, Replace>(t, t_sz, sort);
+  }
   // Delete elements [p, p + t_sz)
   T* Delete(T* p, size_t t_sz) {
     return m_data.Delete(p, t_sz);
@@ -362,22 +564,131 @@ public:
     return Delete(p, Distance(p, p_end));
   }
   // Locate key
+  // The key may be of any type comparable with keys
   // Return: the location of key,
   //         if not found, the location the key should
   //         be inserted
-  template<typename... Hints>
-  Res Locate(const K& key, Hints... hints) const {
-    return LocateR(key, Begin(), End(), hints...);
+  template<typename Q, typename... Hints>
+  Res Locate(const Q& key, Hints... hints) const {
+    return LocateIn(key, Begin(), End(), hints...);
+  }
+  // Get cursor starting from p (begin of set if NULL)
+  Cursor GetCursor(const T* p = NULL) const {
+    return Cursor(this, p ? Distance(Begin(), p) : 0);
   }
   // Find key
   // Return: the location if found
   //         invalid location if not found
-  template<typename... Hints>
-  T* Find(const K& key, Hints... hints) const {
+  template<typename Q, typename... Hints>
+  T* Find(const Q& key, Hints... hints) const {
     Res r = Locate(key, hints...);
     return r.Found() ? *r : NULL;
   }
+  // First element not less than key
+  template<typename Q, typename... Hints>
+  T* LowerBound(const Q& key, Hints... hints) const {
+    return *Locate(key, hints...);
+  }
+  // First element greater than key
+  template<typename Q, typename... Hints>
+  T* UpperBound(const Q& key, Hints... hints) const {
+    Res r = Locate(key, hints...);
+    return r.Found() ? EqualEnd(key, *r) : *r;
+  }
+  // Elements equal to key
+  template<typename Q, typename... Hints>
+  View EqualRange(const Q& key, Hints... hints) const {
+    Res r = Locate(key, hints...);
+    return View(*r, r.Found() ? EqualEnd(key, *r) : *r);
+  }
+  // Elements with key in [lo, hi)
+  // The end is searched after the begin, in the remaining
+  // range only (so it is the begin if hi is not greater than
+  // lo), hints apply to both searches
+  template<typename Q, typename R, typename... Hints>
+  View Range(const Q& lo, const R& hi, Hints... hints) const {
+    T* b = *Locate(lo, hints...);
+    return View(b, *LocateIn(hi, b, End(), hints...));
+  }
+  // Count elements with key in [lo, hi) by two searches
+  template<typename Q, typename R, typename... Hints>
+  size_t CountRange(const Q& lo, const R& hi, Hints... hints) const {
+    return Range(lo, hi, hints...).Size();
+  }
+  // Find batch of keys
+  // Sorted keys are searched by galloping from the previous
+  // hit, unsorted keys are searched in groups of interleaved
+  // binary searches, so memory loads of a group overlap
+  // Input: keys, n - keys to find
+  //        out - found locations, NULL if not found
+  // Return: number of keys found
+  size_t FindBatch(const K* keys, size_t n, T** out) const {
+    size_t i = 1;  // Check if keys are sorted
+    while (i < n && !Less(keys[i], keys[i - 1])) {
+      ++i;
+    }
+    return i >= n ? FindSorted(keys, n, out) : FindGroups(keys, n, out);
+  }
 private:
+  const static size_t BATCH_GROUP = 8;  // Interleaved searches
+  // Find sorted keys by galloping
+  size_t FindSorted(const K* keys, size_t n, T** out) const {
+    size_t found = 0;  // Number of keys found
+    T* s = Begin();  // Lower bound of previous key
+    T* e = End();
+    for (size_t i = 0; i < n; ++i) {
+      Res r = SearchFrom(keys[i], s, e);
+      out[i] = r.Found() ? *r : NULL;
+      found += r.Found();
+      s = *r;
+    }
+    return found;
+  }
+  // Search key in [s, e) by galloping from s, O(log d) for
+  // a key d elements after s
+  Res SearchFrom(const K& key, T* s, T* e) const {
+    size_t sz = e - s;  // Remaining range
+    size_t bound = 1;  // Gallop until key is not less
+    while (bound < sz && Less(GetKey<KEY>(s[bound]), key)) {
+      bound *= 2;
+    }
+    // Lower bound is in (s + bound / 2, s + bound]
+    return Search(key, s + (bound > 1 ? bound / 2 + 1 : 0),
+                  s + JNU_MIN(bound + 1, sz));
+  }
+  // Find unsorted keys by groups of interleaved searches
+  size_t FindGroups(const K* keys, size_t n, T** out) const {
+    size_t found = 0;  // Number of keys found
+    for (size_t g = 0; g < n; g += BATCH_GROUP) {
+      size_t m = JNU_MIN(BATCH_GROUP, n - g);  // Group size
+      const K* k = keys + g;  // Keys of group
+      T* base[BATCH_GROUP];  // Lower bound in [base, base + sz]
+      for (size_t j = 0; j < m; ++j) {
+        base[j] = Begin();
+      }
+      size_t sz = Size();  // Same range size for all searches
+      while (sz > 1) {
+        size_t half = sz / 2;
+        for (size_t j = 0; j < m; ++j) {  // Issue loads together
+          __builtin_prefetch(base[j] + half / 2);
+          __builtin_prefetch(base[j] + half + half / 2);
+        }
+        for (size_t j = 0; j < m; ++j) {
+          const K& mid = GetKey<KEY>(base[j][half - 1]);
+          base[j] = Less(mid, k[j]) ? base[j] + half : base[j];
+        }
+        sz -= half;
+      }
+      for (size_t j = 0; j < m; ++j) {
+        T* p = base[j];  // Candidate
+        bool f = sz && !Less(GetKey<KEY>(*p), k[j]) &&
+                 !Less(k[j], GetKey<KEY>(*p));
+        out[g + j] = f ? p : NULL;
+        found += f;
+      }
+    }
+    return found;
+  }
   // Calculate distance between two iterators
   static size_t Distance(const T* s, const T* e) {
     return memory::Distance(s, e);
@@ -410,12 +721,15 @@ private:
   Res Add(H* t, size_t t_sz,
           T* (C::*insert)(T*, H*, size_t),
           Hints... hints) {
-    if (m_data.Reserve(t_sz)) {  // Reserve space
+    if (m_data.Reserve(Size() + t_sz)) {  // Reserve space
       Res r(m_data.Begin(), false);  // Return result
       // For each input element
       for (size_t i = 0; i < t_sz; ++i) {
         // Find its insert location in target array
         r = Locate(GetKey<KEY>(t[i]), *r, hints...);
+        if constexpr (MULTI) {  // After equal keys
+          r = Res(r.Found() ? EqualEnd(GetKey<KEY>(t[i]), *r) : *r, false);
+        }
         if (!r.Found()) {  // Element not exist
           (m_data.*insert)(*r, t + i, 1);  // Do insert/inject
         } else {  // Element already exists
@@ -432,13 +746,21 @@ private:
   Res Merge(H* t, size_t t_sz,
             T* (C::*insert)(T*, H*, size_t),
             Hints... hints) {
-    if (m_data.Reserve(t_sz)) {  // Reserve space
+    if constexpr (sizeof...(Hints) == 0) {
+      // Without hints, merge from the back in one pass
+      return MergeBack<H, R>(t, t_sz) ? Res(End(), false) : Res();
+    }
+    if (m_data.Reserve(Size() + t_sz)) {  // Reserve space
       H* t_end = t + t_sz;  // End of input array
       H* a = t;  // Start of input array
       T* a_it = m_data.Begin();  // Insert/inject position
+      Res r(a_it, false);  // Location of current element
       while (t < t_end) {  // Loop through input array
         // Find location for current element
-        Res r = Locate(GetKey<KEY>(*t), *r, hints...);
+        r = Locate(GetKey<KEY>(*t), *r, hints...);
+        if constexpr (MULTI) {  // After equal keys
+          r = Res(r.Found() ? EqualEnd(GetKey<KEY>(*t), *r) : *r, false);
+        }
         if (r.Found()) {  // Element exists in target array
           (*R)(*r, t);  // Replace or NoReplace
           (m_data.*insert)(a_it, a, t - a);  // Insert subarray
@@ -459,19 +781,303 @@ private:
     }
     return Res();  // Reserve fail, return invalid position
   }
-  // Less comparison for keys
-  static bool Less(const K& a, const K& b) {
+  // Copy input into bulk buffer
+  template<typename B>
+  static bool Load(B& buf, const T* t, size_t t_sz) {
+    return buf.Copy(t, t_sz);
+  }
+  // Move input into bulk buffer
+  template<typename B>
+  static bool Load(B& buf, T* t, size_t t_sz) {
+    return buf.Move(t, t_sz);
+  }
+  // Bulk insert/inject unsorted array
+  // template arguments:
+  // H - input array type (const for insert
+  //     no const for inject)
+  // R - Replace or NoReplace functor (on buffer elements)
+  // S - stable sort
+  template<typename H, void (*R)(T*, T*), typename S>
+  bool Bulk(H* t, size_t t_sz, S& sort) {
+    memory::MMBase* mm = m_data.GetMM();  // NULL for static array
+    // Sorted input, by memory manager of set
+    DArray<T, Alloc, 1> buf(0, mm ? mm : &memory::MM_BUILDIN);
+    if (!Load(buf, t, t_sz)) {
+      return false;
+    }
+    // Stable sort, keep input order of equal keys
+    sort(buf.Begin(), buf.End(), ItemLess);
+    return MergeBack<T, R>(buf.Begin(), t_sz);
+  }
+  // Merge sorted array from the back
+  // Final size is reserved once, existing elements are
+  // moved at most once
+  // New keys are counted first by galloping searches from the
+  // previous key, O(m log(n / m)) for m input keys, which is
+  // not more than a linear pass
+  // Equal keys in input are applied in order, as if they were
+  // inserted one by one (first wins for NoReplace, last wins
+  // for Replace, all are kept after existing ones for MULTI)
+  // template arguments:
+  // H - input array type (const for insert
+  //     no const for inject)
+  // R - Replace or NoReplace functor
+  // Input: t, t_sz - sorted input array
+  template<typename H, void (*R)(T*, H*)>
+  bool MergeBack(H* t, size_t t_sz) {
+    size_t add = MULTI ? t_sz : 0;  // Number of new keys
+    T* s = Begin();  // Search start, input is sorted
+    for (size_t j = 0; j < t_sz && !MULTI;) {  // Count new keys
+      size_t e = GroupEnd(t, j, t_sz);  // Equal keys [j, e)
+      Res r = SearchFrom(GetKey<KEY>(t[j]), s, End());
+      if (r.Found()) {
+        for (; j < e; ++j) {
+          (*R)(*r, t + j);  // Replace or NoReplace
+        }
+      } else {
+        ++add;
+      }
+      s = *r;
+      j = e;
+    }
+    if (!add) {
+      return true;  // Nothing to merge
+    }
+    size_t i = Size();  // Existing elements not merged yet
+    if (!m_data.Expand(End(), add)) {
+      return false;  // Fail to reserve
+    }
+    T* d = Begin();  // Merge target
+    size_t k = i + add;  // Merge position (exclusive)
+    for (size_t j = t_sz; j > 0;) {
+      // Equal keys [g, j), one at a time for MULTI
+      size_t g = MULTI ? j - 1 : GroupStart(t, j);
+      const K& key = GetKey<KEY>(t[g]);  // Current input key
+      size_t e = i;  // End of existing run bigger than key
+      while (i > 0 && Less(key, GetKey<KEY>(d[i - 1]))) {
+        --i;
+      }
+      Alloc::Move(d + k - (e - i), d + i, e - i);  // Move the run
+      k -= e - i;
+      if (MULTI || i == 0 ||
+          Less(GetKey<KEY>(d[i - 1]), key)) {  // New key
+        Replace(d + --k, t + g);  // Copy or move first
+        for (size_t x = g + 1; x < j; ++x) {
+          (*R)(d + k, t + x);  // Replace or NoReplace
+        }
+      }
+      j = g;
+    }
+    return true;
+  }
+  // End of equal keys starting at j in sorted array
+  template<typename H>
+  static size_t GroupEnd(H* t, size_t j, size_t t_sz) {
+    while (++j < t_sz && !ItemLess(t[j - 1], t[j])) {
+    }
+    return j;
+  }
+  // Start of equal keys ending at j (exclusive) in sorted array
+  template<typename H>
+  static size_t GroupStart(H* t, size_t j) {
+    while (--j > 0 && !ItemLess(t[j - 1], t[j])) {
+    }
+    return j;
+  }
+  // Less comparison for elements
+  static bool ItemLess(const T& a, const T& b) {
+    return Less(GetKey<KEY>(a), GetKey<KEY>(b));
+  }
+  // Less comparison for keys and search keys
+  template<typename A, typename B>
+  static bool Less(const A& a, const B& b) {
     return Compare<LESS>(a, b);
   }
+  // Search key in [s, e) with hints, search key not
+  // transparent is converted to key type
+  template<typename Q, typename... Hints>
+  Res LocateIn(const Q& key, T* s, T* e, Hints... hints) const {
+    if constexpr (TRANSPARENT<Q> || std::is_same<Q, K>::value) {
+      return LocateR(key, s, e, hints...);
+    } else if constexpr (LESS == NULL && MIXED<Q, K>) {
+      K k;  // Key value of search key
+      return FitKey(key, k) ? LocateR(k, s, e, hints...) :
+                              LocateR(key, s, e, hints...);
+    } else {
+      const K& k = ToKey(key);  // Converted once
+      return LocateR(k, s, e, hints...);
+    }
+  }
+  // Convert search key to key type
+  // Search keys are converted as LESS takes keys
+  template<typename Q>
+  static K ToKey(const Q& key) {
+    return key;
+  }
+  // Convert arithmetic search key to key type if its value is
+  // a key value, range checked before conversion (a search key
+  // 5.5 or -1 is not a key of int or unsigned keys)
+  // Return: if converted
+  template<typename Q>
+  static bool FitKey(const Q& key, K& k) {
+    typedef std::numeric_limits<K> Limits;
+    if constexpr (std::is_floating_point<Q>::value) {
+      if (key != key) {  // NaN
+        return false;
+      }
+    }
+    if (Compare<LESS>(key, Limits::lowest()) ||
+        Compare<LESS>(Limits::max(), key)) {
+      return false;  // Out of key range
+    }
+    k = (K) key;
+    return !Compare<LESS>(k, key) && !Compare<LESS>(key, k);
+  }
+  // Exact less comparison of mixed arithmetic types
+  // A negative integer is less than every unsigned integer,
+  // integer and floating point are ordered by their values
+  template<typename A, typename B>
+  static bool ExactLess(const A& a, const B& b) {
+    if constexpr (std::is_integral<A>::value &&
+                  std::is_integral<B>::value) {
+      typedef typename std::make_unsigned<A>::type UA;
+      typedef typename std::make_unsigned<B>::type UB;
+      if constexpr (std::is_signed<A>::value) {
+        return a < 0 || (UA) a < b;
+      } else {
+        return b >= 0 && a < (UB) b;
+      }
+    } else if constexpr (std::is_integral<A>::value) {
+      return Order(a, b) < 0;
+    } else {
+      return Order(b, a) > 0;
+    }
+  }
+  // Order of integer i and floating point f, f is range
+  // checked before truncated to integer type
+  // Return: -1 if i < f, 1 if f < i, 0 if equal or f is NaN
+  template<typename I, typename F>
+  static int Order(const I& i, const F& f) {
+    // Integers are less than hi (power of 2, exact in F)
+    const F hi = F(2) * F(std::numeric_limits<I>::max() / 2 + 1);
+    if (f != f) {
+      return 0;  // NaN, unordered
+    }
+    if (f >= hi) {
+      return -1;
+    }
+    if (std::is_signed<I>::value ? f < -hi : f <= F(-1)) {
+      return 1;
+    }
+    I t = (I) f;  // Truncated toward zero, exact in F
+    if (i != t) {  // f is in (t - 1, t + 1)
+      return i < t ? -1 : 1;
+    }
+    return t < f ? -1 : (f < t ? 1 : 0);
+  }
+  // Locate key from finger, for cursors
+  template<typename Q>
+  Res LocateFrom(const Q& key, size_t& finger) const {
+    if constexpr (TRANSPARENT<Q> || std::is_same<Q, K>::value) {
+      return Gallop(key, Begin(), End(), finger);
+    } else if constexpr (LESS == NULL && MIXED<Q, K>) {
+      K k;  // Key value of search key
+      return FitKey(key, k) ? Gallop(k, Begin(), End(), finger) :
+                              Gallop(key, Begin(), End(), finger);
+    } else {
+      const K& k = ToKey(key);  // Converted once
+      return Gallop(k, Begin(), End(), finger);
+    }
+  }
+  // Search key in [s, e) by galloping outward from finger,
+  // finger is moved to the result
+  // Finger out of range falls back to binary search
+  template<typename Q>
+  Res Gallop(const Q& key, T* s, T* e, size_t& finger) const {
+    Res r;  // Search result
+    size_t sz = Size();  // Set size, finger may be out of it
+    T* f = sz ? Begin() + JNU_MIN(finger, sz - 1) : e;  // Finger element
+    if (f < s || f >= e) {
+      r = Search(key, s, e);
+    } else if (Less(GetKey<KEY>(*f), key)) {  // After finger
+      size_t n = e - f;  // Elements from finger
+      size_t bound = 1;  // Gallop until key is not less
+      while (bound < n && Less(GetKey<KEY>(f[bound]), key)) {
+        bound *= 2;
+      }
+      // Lower bound is in (f + bound / 2, f + bound]
+      r = Search(key, f + bound / 2 + 1, f + JNU_MIN(bound + 1, n));
+    } else {  // Not after finger
+      size_t n = f - s + 1;  // Elements to finger
+      size_t bound = 1;  // Gallop until key is greater
+      while (bound < n && !Less(GetKey<KEY>(*(f - bound)), key)) {
+        bound *= 2;
+      }
+      // Lower bound is in (f - bound, f - bound / 2]
+      r = Search(key, bound < n ? f - bound + 1 : s, f - bound / 2 + 1);
+    }
+    finger = *r - Begin();
+    return r;
+  }
+  // End of elements equal to key, from its first element p
+  // Galloping, runs of equal keys are short mostly
+  template<typename Q>
+  T* EqualEnd(const Q& key, T* p) const {
+    if constexpr (!MULTI) {
+      return p + 1;
+    } else if constexpr (LESS == NULL && MIXED<Q, K>) {
+      K k;  // Found search key is a key value
+      FitKey(key, k);
+      return EqualEnd(k, p);
+    } else if constexpr (!TRANSPARENT<Q> && !std::is_same<Q, K>::value) {
+      const K& k = ToKey(key);  // Converted once
+      return EqualEnd(k, p);
+    } else {
+      size_t n = End() - p;  // Remaining elements
+      size_t bound = 1;  // Gallop until key is less
+      while (bound < n && !Less(key, GetKey<KEY>(p[bound]))) {
+        bound *= 2;
+      }
+      // End is in (p + bound / 2, p + bound]
+      T* s = p + bound / 2 + 1;
+      T* e = p + JNU_MIN(bound, n);
+      while (s < e) {
+        T* mid = s + (e - s) / 2;  // Middle of range
+        if (Less(key, GetKey<KEY>(*mid))) {
+          e = mid;
+        } else {
+          s = mid + 1;
+        }
+      }
+      return s;
+    }
+  }
   // Search key position in array
   // Input: key - search key
   //        s, e - the search range
-  Res Search(const Key& key, T* s, T* e) const {
+  template<typename Q>
+  Res Search(const Q& key, T* s, T* e) const {
+    if constexpr (FAST_SEARCH && std::is_same<Q, K>::value) {
+      T* p = LowerBound<KEY>(key, s, e);
+      return Res(p, p < e && !Less(key, GetKey<KEY>(*p)));
+    }
+    if constexpr (MULTI) {  // Lower bound, first of equal keys
+      T* end = e;  // End of range
+      while (s < e) {
+        T* mid = s + (e - s) / 2;  // Middle of range
+        if (Less(GetKey<KEY>(*mid), key)) {
+          s = mid + 1;
+        } else {
+          e = mid;
+        }
+      }
+      return Res(s, s < end && !Less(key, GetKey<KEY>(*s)));
+    }
     T* start = s;  // Start range
     T* end = e;  // End range (not exclusive)
     while (start < end) {  // Valid range
       T* mid = start + (end - start) / 2;  // Middle of range
-      const Key& mid_key = GetKey<KEY>(*mid);  // Middle key
+      const K& mid_key = GetKey<KEY>(*mid);  // Middle key
       if (Less(key, mid_key)) {  // Less than middle
         end = mid;  // Shrink range end to middle
       } else if (Less(mid_key, key)) {  // Bigger than middle
@@ -482,13 +1088,34 @@ private:
     }
     return Res(start, false);  // Not find, insert position
   }
+  // Lower bound of plain key array, SIMD finished
+  template<decltype(KEY) L>
+  static typename std::enable_if<L == NULL &&
+                                 std::is_same<T, K>::value, T*>::type
+  LowerBound(const K& key, T* s, T* e) {
+    return search::LowerBound(s, e, key);
+  }
+  // Lower bound of elements with arithmetic keys
+  template<decltype(KEY) L>
+  static typename std::enable_if<L != NULL ||
+                                 !std::is_same<T, K>::value, T*>::type
+  LowerBound(const K& key, T* s, T* e) {
+    return search::LowerBound(s, e, key, [](const T& t) -> const K& {
+      return GetKey<KEY>(t);
+    });
+  }
   // Recursive search with hints
-  Res LocateR(const K& key, T* s, T* e) const {
+  // Searches from finger in finger mode
+  template<typename Q>
+  Res LocateR(const Q& key, T* s, T* e) const {
+    if constexpr (FINGER) {
+      return Gallop(key, s, e, m_finger);
+    }
     return Search(key, s, e);
   }
   // Search with hints
-  template<typename... Hints>
-  Res LocateR(const K& key, T* s, T* e,
+  template<typename Q, typename... Hints>
+  Res LocateR(const Q& key, T* s, T* e,
               T* hint, Hints... hints) const {
     if (hint < s || hint >= e) {  // hint not in search range
       return LocateR(key, s, e, hints...);  // Skip to next hint
@@ -502,30 +1129,56 @@ private:
       // Use hint + 1 as search range start
       return LocateR(key, hint + 1, e, hints...);
     }
+    if constexpr (MULTI) {  // First equal key is not after hint
+      return Res(*LocateR(key, s, hint, hints...), true);
+    }
     return Res(hint, true);  // Equal to hint, return found
   }
   C m_data;  // Underline array
+  mutable size_t m_finger;  // Offset of last location (FINGER)
 };
 // Array set (underline element as key)
 // C - underline array type
 // LESS - Comparison of element
+// OPT - options (ARR_SET_*)
 template<typename C,
          auto LESS = (bool (*) (const typename C::Type&,
-                                const typename C::Type&)) NULL>
+                                const typename C::Type&)) NULL,
+         int OPT = 0>
 using ArraySet = ArraySetT<C, typename C::Type,
                            (const typename C::Type& (*)
                            (const typename C::Type)) NULL,
-                           LESS>;
+                           LESS, OPT>;
 // Array map (element is a pair object)
 // Using first object as key
 // LESS - Comparison of first object
+// OPT - options (ARR_SET_*)
 template<typename C,
          auto LESS = (bool (*) (const typename C::Type::FirstType&,
-                                const typename C::Type::FirstType&)) NULL>
+                                const typename C::Type::FirstType&)) NULL,
+         int OPT = 0>
 using ArrayMap = ArraySetT<C,
                            typename C::Type::FirstType,
                            C::Type::GetFirst,
-                           LESS>;
+                           LESS, OPT>;
+// Array set with equal elements, in insertion order
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type&,
+                                const typename C::Type&)) NULL,
+         int OPT = 0>
+using ArrayMultiSet = ArraySetT<C, typename C::Type,
+                                (const typename C::Type& (*)
+                                (const typename C::Type)) NULL,
+                                LESS, ARR_SET_MULTI | OPT>;
+// Array map with equal keys, in insertion order
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type::FirstType&,
+                                const typename C::Type::FirstType&)) NULL,
+         int OPT = 0>
+using ArrayMultiMap = ArraySetT<C,
+                                typename C::Type::FirstType,
+                                C::Type::GetFirst,
+                                LESS, ARR_SET_MULTI | OPT>;
 }
 
 #endif
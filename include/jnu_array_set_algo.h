@@ -0,0 +1,263 @@
+// By JNI
+// Set algebra on sorted array sets: union, intersection,
+// difference and symmetric difference
+// Two sets are merged in one pass, a run of keys of one set
+// smaller than current key of the other set is skipped by
+// galloping (exponential search) when set sizes are very
+// different, otherwise by linear scan
+// Intersection of plain 32 or 64 bit integer sets of similar
+// sizes compares blocks of keys all against all by SSE2
+// Results go to a callback f(const T&) in sorted order, or
+// to a third set (which must not be one of the inputs)
+
+#ifndef JNU_ARRAY_SET_ALGO_H
+#define JNU_ARRAY_SET_ALGO_H
+
+#include <stddef.h>
+#include <type_traits>
+#include <emmintrin.h>
+#include "jnu_defines.h"
+#include "jnu_array_set.h"
+
+namespace jnu {
+namespace algo {
+const static size_t GALLOP_RATIO = 16;  // Size ratio to gallop
+const static int KEEP_A = 1;  // Keep keys only in first set
+const static int KEEP_B = 2;  // Keep keys only in second set
+const static int KEEP_BOTH = 4;  // Keep keys in both sets
+// First position in [i, n) with key not less than key
+// Template arguments:
+// S - the set type
+// GALLOP - gallop or scan linearly
+template<typename S, bool GALLOP>
+size_t Skip(const typename S::Type* p, size_t i, size_t n,
+            const typename S::Key& key) {
+  if constexpr (!GALLOP) {  // Linear scan
+    while (i < n && S::KeyLess(S::KeyOf(p[i]), key)) {
+      ++i;
+    }
+    return i;
+  }
+  size_t step = 1;  // Gallop while keys are less
+  while (i + step <= n && S::KeyLess(S::KeyOf(p[i + step - 1]), key)) {
+    i += step;
+    step *= 2;
+  }
+  size_t e = JNU_MIN(i + step - 1, n);  // Position is in [i, e]
+  while (i < e) {  // Binary search
+    size_t mid = i + (e - i) / 2;
+    if (S::KeyLess(S::KeyOf(p[mid]), key)) {
+      i = mid + 1;
+    } else {
+      e = mid;
+    }
+  }
+  return i;
+}
+// Output elements [s, e)
+// Return: number of elements
+template<typename T, typename F>
+size_t Emit(const T* s, const T* e, F& f) {
+  for (const T* p = s; p < e; ++p) {
+    f(*p);
+  }
+  return e - s;
+}
+// Merge two sorted ranges [pa + i, pa + na), [pb + j, pb + nb)
+// Template arguments:
+// KEEP - the keys to output (KEEP_A, KEEP_B, KEEP_BOTH)
+// GALLOP - skip runs by galloping
+// Return: number of elements output
+template<int KEEP, bool GALLOP, typename S, typename F>
+size_t Merge(const typename S::Type* pa, size_t i, size_t na,
+             const typename S::Type* pb, size_t j, size_t nb, F& f) {
+  size_t c = 0;  // Number of elements output
+  while (i < na && j < nb) {
+    const typename S::Key& ka = S::KeyOf(pa[i]);
+    const typename S::Key& kb = S::KeyOf(pb[j]);
+    if (S::KeyLess(ka, kb)) {  // Run of first set
+      size_t e = Skip<S, GALLOP>(pa, i + 1, na, kb);
+      if constexpr ((KEEP & KEEP_A) != 0) {
+        c += Emit(pa + i, pa + e, f);
+      }
+      i = e;
+    } else if (S::KeyLess(kb, ka)) {  // Run of second set
+      size_t e = Skip<S, GALLOP>(pb, j + 1, nb, ka);
+      if constexpr ((KEEP & KEEP_B) != 0) {
+        c += Emit(pb + j, pb + e, f);
+      }
+      j = e;
+    } else {  // Key in both sets
+      if constexpr ((KEEP & KEEP_BOTH) != 0) {
+        f(pa[i]);
+        ++c;
+      }
+      ++i;
+      ++j;
+    }
+  }
+  if constexpr ((KEEP & KEEP_A) != 0) {  // Tail of first set
+    c += Emit(pa + i, pa + na, f);
+  }
+  if constexpr ((KEEP & KEEP_B) != 0) {  // Tail of second set
+    c += Emit(pb + j, pb + nb, f);
+  }
+  return c;
+}
+// Mask of 4 keys of a equal to any of 4 keys of b (32 bit)
+template<typename T>
+typename std::enable_if<sizeof(T) == 4, int>::type
+BlockMatch(const T* a, const T* b) {
+  __m128i va = _mm_loadu_si128((const __m128i*) a);
+  __m128i vb = _mm_loadu_si128((const __m128i*) b);
+  __m128i m = _mm_cmpeq_epi32(va, vb);  // Compare all rotations
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va,
+        _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va,
+        _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va,
+        _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+  return _mm_movemask_ps(_mm_castsi128_ps(m));
+}
+// Equality of 64 bit lanes (SSE2 has 32 bit compare only)
+static inline __m128i Equal64(__m128i a, __m128i b) {
+  __m128i e = _mm_cmpeq_epi32(a, b);
+  return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+// Mask of 2 keys of a equal to any of 2 keys of b (64 bit)
+template<typename T>
+typename std::enable_if<sizeof(T) == 8, int>::type
+BlockMatch(const T* a, const T* b) {
+  __m128i va = _mm_loadu_si128((const __m128i*) a);
+  __m128i vb = _mm_loadu_si128((const __m128i*) b);
+  __m128i m = _mm_or_si128(Equal64(va, vb), Equal64(va,
+                _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+  return _mm_movemask_pd(_mm_castsi128_pd(m));
+}
+// Intersect by blocks of keys while both ranges have a full
+// block, the block with smaller last key is advanced
+// Input: i, j - start positions, updated to where it stops
+// Return: number of elements output
+template<typename T, typename F>
+size_t IntersectBlocks(const T* pa, size_t& i, size_t na,
+                       const T* pb, size_t& j, size_t nb, F& f) {
+  const size_t W = 16 / sizeof(T);  // Keys per block
+  size_t c = 0;  // Number of elements output
+  while (i + W <= na && j + W <= nb) {
+    int m = BlockMatch(pa + i, pb + j);
+    while (m) {  // Matched keys in order
+      f(pa[i + __builtin_ctz(m)]);
+      ++c;
+      m &= m - 1;
+    }
+    T a_last = pa[i + W - 1];  // Last keys of blocks
+    T b_last = pb[j + W - 1];
+    i += a_last <= b_last ? W : 0;
+    j += b_last <= a_last ? W : 0;
+  }
+  return c;
+}
+// Run set operation to callback
+template<int KEEP, typename S, typename F>
+size_t Run(const S& a, const S& b, F& f) {
+  typedef typename S::Type T;
+  const T* pa = a.Begin();
+  const T* pb = b.Begin();
+  size_t na = a.Size();
+  size_t nb = b.Size();
+  size_t i = 0;  // Positions to merge from
+  size_t j = 0;
+  if (JNU_MAX(na, nb) >= GALLOP_RATIO * JNU_MIN(na, nb)) {
+    return Merge<KEEP, true, S>(pa, i, na, pb, j, nb, f);
+  }
+  size_t c = 0;  // Number of elements output
+  if constexpr (KEEP == KEEP_BOTH && S::PLAIN_KEY &&
+                std::is_integral<T>::value &&
+                (sizeof(T) == 4 || sizeof(T) == 8)) {
+    c = IntersectBlocks(pa, i, na, pb, j, nb, f);
+  }
+  return c + Merge<KEEP, false, S>(pa, i, na, pb, j, nb, f);
+}
+// Append elements to set in sorted order
+template<typename S>
+class SetAppender {
+public:
+  // Constructor
+  SetAppender(S& s)
+    : m_set (s),
+      m_ok (true) {
+  }
+  // Append element
+  void operator()(const typename S::Type& t) {
+    m_ok = m_ok && m_set.Data().Insert(m_set.End(), t, 1);
+  }
+  // Check if all elements appended
+  bool Ok() const {
+    return m_ok;
+  }
+private:
+  S& m_set;  // Output set
+  bool m_ok;  // All elements appended
+};
+// Run set operation to set
+template<int KEEP, typename S>
+bool RunTo(const S& a, const S& b, S& out, size_t rsv_sz) {
+  out.Clear();
+  if (!out.Reserve(rsv_sz)) {
+    return false;
+  }
+  SetAppender<S> f(out);
+  Run<KEEP>(a, b, f);
+  return f.Ok();
+}
+// Union of two sets to callback
+// Keys in both sets are output from the first set
+// Return: number of elements output
+template<typename S, typename F>
+size_t Union(const S& a, const S& b, F f) {
+  return Run<KEEP_A | KEEP_B | KEEP_BOTH>(a, b, f);
+}
+// Union of two sets to third set
+template<typename S>
+bool Union(const S& a, const S& b, S& out) {
+  return RunTo<KEEP_A | KEEP_B | KEEP_BOTH>(a, b, out,
+                                             a.Size() + b.Size());
+}
+// Intersection of two sets to callback
+// Elements are output from the first set
+// Return: number of elements output
+template<typename S, typename F>
+size_t Intersect(const S& a, const S& b, F f) {
+  return Run<KEEP_BOTH>(a, b, f);
+}
+// Intersection of two sets to third set
+template<typename S>
+bool Intersect(const S& a, const S& b, S& out) {
+  return RunTo<KEEP_BOTH>(a, b, out, JNU_MIN(a.Size(), b.Size()));
+}
+// Keys of first set not in second set to callback
+// Return: number of elements output
+template<typename S, typename F>
+size_t Difference(const S& a, const S& b, F f) {
+  return Run<KEEP_A>(a, b, f);
+}
+// Keys of first set not in second set to third set
+template<typename S>
+bool Difference(const S& a, const S& b, S& out) {
+  return RunTo<KEEP_A>(a, b, out, a.Size());
+}
+// Keys in only one of two sets to callback
+// Return: number of elements output
+template<typename S, typename F>
+size_t SymmetricDifference(const S& a, const S& b, F f) {
+  return Run<KEEP_A | KEEP_B>(a, b, f);
+}
+// Keys in only one of two sets to third set
+template<typename S>
+bool SymmetricDifference(const S& a, const S& b, S& out) {
+  return RunTo<KEEP_A | KEEP_B>(a, b, out, a.Size() + b.Size());
+}
+}
+}
+
+#endif
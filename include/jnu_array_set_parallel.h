@@ -0,0 +1,64 @@
+// By JNI
+// Parallel bulk insertion of sorted set
+// Bulk input is sorted by a thread pool before it is merged
+// into the set, sets which do not use it are free of thread
+// pool dependency
+
+#ifndef JNU_ARRAY_SET_PARALLEL_H
+#define JNU_ARRAY_SET_PARALLEL_H
+
+#include "jnu_array_set.h"
+#include "jnu_parallel.h"
+#include "jnu_thread_pool.h"
+
+namespace jnu {
+namespace parallel {
+// Stable sort on thread pool, as sort of bulk insertion
+class PoolSort {
+public:
+  // Constructor
+  // Input: p - thread pool
+  explicit PoolSort(ThreadPool& p)
+    : m_pool (p) {
+  }
+  // Sort [first, last) by less
+  template<typename T, typename LT>
+  void operator()(T* first, T* last, LT less) const {
+    Sort(m_pool, first, last, less);
+  }
+private:
+  ThreadPool& m_pool;  // Thread pool
+};
+// No replace bulk insert (unsorted) array, sorted on pool
+// Input: p - thread pool
+//        s - sorted set (ArraySetT)
+//        t, t_sz - input data array
+// Return: true - insert successful
+template<typename S>
+bool BulkInsert(ThreadPool& p, S& s,
+                const typename S::Type* t, size_t t_sz) {
+  return s.BulkInsert(t, t_sz, PoolSort(p));
+}
+// Replace bulk insert, for duplicated keys in input the
+// last one wins
+template<typename S>
+bool ReplaceBulkInsert(ThreadPool& p, S& s,
+                       const typename S::Type* t, size_t t_sz) {
+  return s.ReplaceBulkInsert(t, t_sz, PoolSort(p));
+}
+// No replace bulk inject (unsorted) array
+// Elements in array will be moved to set
+template<typename S>
+bool BulkInject(ThreadPool& p, S& s, typename S::Type* t, size_t t_sz) {
+  return s.BulkInject(t, t_sz, PoolSort(p));
+}
+// Replace bulk inject
+template<typename S>
+bool ReplaceBulkInject(ThreadPool& p, S& s,
+                       typename S::Type* t, size_t t_sz) {
+  return s.ReplaceBulkInject(t, t_sz, PoolSort(p));
+}
+}
+}
+
+#endif
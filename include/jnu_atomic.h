@@ -4,7 +4,9 @@
 #ifndef JNU_ATOMIC_H
 #define JNU_ATOMIC_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <type_traits>
 
 namespace jnu {
 namespace atomic {
@@ -20,6 +22,9 @@ const static MemoryOrder MO_SEQ_CST = __ATOMIC_SEQ_CST;
 // Base class for wrapping atomic buildins
 // Template parameters:
 // C: underline date type (1 - 8 bytes)
+//    Floating point types are supported, arithmetic
+//    operations on them are done by compare and exchange
+//    loops on the bit pattern
 // MO_R, MO_W, MO_RW: Default memory orders for
 //                    read, write, and read/write
 template<typename C,
@@ -27,6 +32,15 @@ template<typename C,
          MemoryOrder MO_W = MO_RELAXED,
          MemoryOrder MO_RW = MO_RELAXED>
 class Base {
+  // Check if type T is floating point
+  template<typename T>
+  using IsFloat = typename std::is_floating_point<T>;
+  // Enable if T is floating point
+  template<typename T>
+  using Float = typename std::enable_if<IsFloat<T>::value, T>::type;
+  // Enable if T is not floating point
+  template<typename T>
+  using NFloat = typename std::enable_if<!IsFloat<T>::value, T>::type;
 public:
   typedef C Type;  // Define of underline data type
   // Default constructor
@@ -89,15 +103,21 @@ public:
   }
   // Atomic load
   C Load(const MemoryOrder& mo = MO_R) const {
-    return __atomic_load_n(&m_val, mo);
+    C t;
+    __atomic_load(&m_val, &t, mo);
+    return t;
   }
   // Atomic store
   void Store(const C& val, const MemoryOrder& mo = MO_W) {
-    __atomic_store_n(&m_val, val, mo);
+    C t = val;
+    __atomic_store(&m_val, &t, mo);
   }
   // Atomic exchange
   C Exchange(const C& val, const MemoryOrder& mo = MO_RW) {
-    return __atomic_exchange_n(&m_val, val, mo);
+    C t = val;
+    C r;
+    __atomic_exchange(&m_val, &t, &r, mo);
+    return r;
   }
   // Atomic compare and exchange
   // Input: expected : the value for comparison
@@ -108,16 +128,40 @@ public:
                        const MemoryOrder& mo_succ = MO_RW,
                        const MemoryOrder& mo_fail = MO_R) {
     C t = expected;
-    return __atomic_compare_exchange_n(&m_val, &t, desired,
-                                       true, mo_succ, mo_fail);
+    return DoCompareExchange(t, desired, mo_succ, mo_fail);
+  }
+  // Atomic weak compare and exchange, it may fail spuriously
+  // Input: expected : the value for comparison, on fail it is
+  //                   updated with the current value
+  //        desired: store the value if equal to expected
+  //        mo_succ: for comparison success (read/write operation)
+  //        mo_fail: for comparison fail (read only operation)
+  bool CompareExchangeWeak(C& expected, const C& desired,
+                           const MemoryOrder& mo_succ = MO_RW,
+                           const MemoryOrder& mo_fail = MO_R) {
+    return DoCompareExchange(expected, desired, mo_succ, mo_fail);
+  }
+  // Atomic strong compare and exchange, it fails only if
+  // value is not equal to expected
+  // Input: expected : the value for comparison, on fail it is
+  //                   updated with the current value
+  //        desired: store the value if equal to expected
+  //        mo_succ: for comparison success (read/write operation)
+  //        mo_fail: for comparison fail (read only operation)
+  bool CompareExchangeStrong(C& expected, const C& desired,
+                             const MemoryOrder& mo_succ = MO_RW,
+                             const MemoryOrder& mo_fail = MO_R) {
+    C t = desired;
+    return __atomic_compare_exchange(&m_val, &expected, &t,
+                                     false, mo_succ, mo_fail);
   }
   // Atomic add fetch
   C AddFetch(const C& val, const MemoryOrder& mo = MO_RW) {
-    return __atomic_add_fetch(&m_val, val, mo);
+    return DoAddFetch<C>(val, mo);
   }
   // Atomic sub fetch
   C SubFetch(const C& val, const MemoryOrder& mo = MO_RW) {
-    return __atomic_sub_fetch(&m_val, val, mo);
+    return DoSubFetch<C>(val, mo);
   }
   // Atomic and fetch
   C AndFetch(const C& val, const MemoryOrder& mo = MO_RW) {
@@ -137,11 +181,11 @@ public:
   }
   // Atomic fetch add
   C FetchAdd(const C& val, const MemoryOrder& mo = MO_RW) {
-    return __atomic_fetch_add(&m_val, val, mo);
+    return DoFetchAdd<C>(val, mo);
   }
   // Atomic fetch sub
   C FetchSub(const C& val, const MemoryOrder& mo = MO_RW) {
-    return __atomic_fetch_sub(&m_val, val, mo);
+    return DoFetchSub<C>(val, mo);
   }
   // Atomic fetch and
   C FetchAnd(const C& val, const MemoryOrder& mo = MO_RW) {
@@ -159,6 +203,38 @@ public:
   C FetchNand(const C& val, const MemoryOrder& mo = MO_RW) {
     return __atomic_fetch_nand(&m_val, val, mo);
   }
+  // Atomic fetch min, store val if it is less than
+  // the current value
+  // Return: the value before the operation
+  C FetchMin(const C& val, const MemoryOrder& mo = MO_RW) {
+    C t = Load(FailOrder(mo));  // Current value
+    // Only write when val is smaller
+    while (val < t && !DoCompareExchange(t, val, mo, FailOrder(mo))) {
+    }
+    return t;
+  }
+  // Atomic fetch max, store val if it is bigger than
+  // the current value
+  // Return: the value before the operation
+  C FetchMax(const C& val, const MemoryOrder& mo = MO_RW) {
+    C t = Load(FailOrder(mo));  // Current value
+    // Only write when val is bigger
+    while (t < val && !DoCompareExchange(t, val, mo, FailOrder(mo))) {
+    }
+    return t;
+  }
+  // Atomic min fetch
+  // Return: the value after the operation
+  C MinFetch(const C& val, const MemoryOrder& mo = MO_RW) {
+    C t = FetchMin(val, mo);
+    return val < t ? val : t;
+  }
+  // Atomic max fetch
+  // Return: the value after the operation
+  C MaxFetch(const C& val, const MemoryOrder& mo = MO_RW) {
+    C t = FetchMax(val, mo);
+    return t < val ? val : t;
+  }
   // Atomic test and set (only for byte data types)
   bool TestAndSet(const MemoryOrder& mo = MO_RW) {
     static_assert(sizeof(C) == 1,
@@ -172,6 +248,77 @@ public:
     return __atomic_clear(&m_val, mo);
   }
 private:
+  // Memory order for the failed comparison of
+  // compare and exchange, it cannot contain release
+  static constexpr MemoryOrder FailOrder(const MemoryOrder& mo) {
+    return mo == MO_RELEASE ? MO_RELAXED :
+           mo == MO_ACQ_REL ? MO_ACQUIRE : mo;
+  }
+  // Weak compare and exchange on the bit pattern
+  // On fail, expected is updated with the current value
+  bool DoCompareExchange(C& expected, const C& desired,
+                         const MemoryOrder& mo_succ,
+                         const MemoryOrder& mo_fail) {
+    C t = desired;
+    return __atomic_compare_exchange(&m_val, &expected, &t,
+                                     true, mo_succ, mo_fail);
+  }
+  // Update value with F by compare and exchange loop
+  // Return: the value before the update
+  template<C (*F)(const C&, const C&)>
+  C FetchUpdate(const C& val, const MemoryOrder& mo) {
+    C t = Load(MO_RELAXED);  // Current value
+    while (!DoCompareExchange(t, F(t, val), mo, FailOrder(mo))) {
+    }
+    return t;
+  }
+  // Add and sub used by FetchUpdate
+  static C Add(const C& a, const C& b) {
+    return a + b;
+  }
+  static C Sub(const C& a, const C& b) {
+    return a - b;
+  }
+  // Fetch add of integer types, use buildin
+  template<typename T>
+  NFloat<T> DoFetchAdd(const C& val, const MemoryOrder& mo) {
+    return __atomic_fetch_add(&m_val, val, mo);
+  }
+  // Fetch add of floating point types
+  template<typename T>
+  Float<T> DoFetchAdd(const C& val, const MemoryOrder& mo) {
+    return FetchUpdate<Add>(val, mo);
+  }
+  // Fetch sub of integer types, use buildin
+  template<typename T>
+  NFloat<T> DoFetchSub(const C& val, const MemoryOrder& mo) {
+    return __atomic_fetch_sub(&m_val, val, mo);
+  }
+  // Fetch sub of floating point types
+  template<typename T>
+  Float<T> DoFetchSub(const C& val, const MemoryOrder& mo) {
+    return FetchUpdate<Sub>(val, mo);
+  }
+  // Add fetch of integer types, use buildin
+  template<typename T>
+  NFloat<T> DoAddFetch(const C& val, const MemoryOrder& mo) {
+    return __atomic_add_fetch(&m_val, val, mo);
+  }
+  // Add fetch of floating point types
+  template<typename T>
+  Float<T> DoAddFetch(const C& val, const MemoryOrder& mo) {
+    return FetchUpdate<Add>(val, mo) + val;
+  }
+  // Sub fetch of integer types, use buildin
+  template<typename T>
+  NFloat<T> DoSubFetch(const C& val, const MemoryOrder& mo) {
+    return __atomic_sub_fetch(&m_val, val, mo);
+  }
+  // Sub fetch of floating point types
+  template<typename T>
+  Float<T> DoSubFetch(const C& val, const MemoryOrder& mo) {
+    return FetchUpdate<Sub>(val, mo) - val;
+  }
   C m_val;  // Underline data
 };
 // Define of supported data types
@@ -202,16 +349,18 @@ public:
   using UInt32 = Base<uint32_t, MO_R, MO_W, MO_RW>;
   using Int64 = Base<int64_t, MO_R, MO_W, MO_RW>;
   using UInt64 = Base<uint64_t, MO_R, MO_W, MO_RW>;
+  using Float = Base<float, MO_R, MO_W, MO_RW>;
+  using Double = Base<double, MO_R, MO_W, MO_RW>;
 private:
   // Private constructor, make sure it is static only
   Type() {}
 };
 // Apply thread fence
-static void ThreadFence(const MemoryOrder& mo) {
+static inline void ThreadFence(const MemoryOrder& mo) {
   __atomic_thread_fence(mo);
 }
 // Apply signal fence
-static void SignalFence(const MemoryOrder& mo) {
+static inline void SignalFence(const MemoryOrder& mo) {
   __atomic_signal_fence(mo);
 }
 }
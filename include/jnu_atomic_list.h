@@ -0,0 +1,232 @@
+// By JNI
+// Implementation of concurrent containers on the base of
+// single link list nodes
+// Like link lists, objects are linked by the nodes buried
+// inside, so pushing or popping needs no memory allocation
+
+#ifndef JNU_ATOMIC_LIST_H
+#define JNU_ATOMIC_LIST_H
+
+#include "jnu_defines.h"
+#include "jnu_atomic.h"
+#include "jnu_list.h"
+
+namespace jnu {
+// Lock-free stack (Treiber stack)
+// The stack head is a tagged pointer: the upper 16 bits
+// hold a counter changed by every update, which prevents
+// the ABA problem of pop
+// Note: popped objects may still be read by concurrent
+// pops, so they must stay valid (e.g. recycled in a pool)
+// while the stack is in use
+// Template arguments:
+// C - target object type
+// F - member function for getting the link node
+template<typename C, typename SLink<C>::Node& (C::*F)()>
+class AtomicStack {
+  typedef typename SLink<C>::Node Node;  // Link node
+  static constexpr unsigned int PTR_BITS = 48;  // Bits of pointer
+  static constexpr uint64_t PTR_MASK = ((uint64_t) 1 << PTR_BITS) - 1;
+  static_assert(sizeof(void*) == sizeof(uint64_t),
+                "AtomicStack requires 64-bit pointers");
+public:
+  typedef C Type;  // Type of target object
+  typedef typename SLink<C>::template List<F> List;  // Single list
+  // Default constructor
+  AtomicStack()
+    : m_head (0) {
+  }
+  // Deconstructor
+  ~AtomicStack() {
+  }
+  // Keep unique, no copy constructor allowed
+  AtomicStack(const AtomicStack& s) = delete;
+  // Keep unique, no assign operator allowed
+  AtomicStack& operator=(const AtomicStack& s) = delete;
+  // Check if stack is empty (snapshot)
+  bool IsEmpty() const {
+    return !Ptr(m_head.Load(atomic::MO_RELAXED));
+  }
+  // Push object 'obj'
+  void Push(C& obj) {
+    Push(obj, obj);
+  }
+  // Push list 'ls' with single update of stack head
+  // The list head becomes stack top
+  void Push(List&& ls) {
+    if (!ls.IsEmpty()) {
+      Push(*ls.Head(), *ls.Tail());
+      ls.Clear();
+    }
+  }
+  // Pop stack top
+  // Return: the popped object, NULL if stack is empty
+  C* Pop() {
+    uint64_t h = m_head.Load(atomic::MO_ACQUIRE);  // Current head
+    while (C* top = Ptr(h)) {  // Stack not empty
+      // Replace head with next of top
+      if (m_head.CompareExchangeWeak(h, Pack(Next(*top), h),
+                                     atomic::MO_ACQUIRE,
+                                     atomic::MO_ACQUIRE)) {
+        SetNext(*top, NULL);  // Unlink popped object
+        return top;
+      }
+    }
+    return NULL;  // Empty
+  }
+  // Pop all objects with single update of stack head
+  // Return: list of popped objects, list head is stack top
+  List PopAll() {
+    uint64_t h = m_head.Load(atomic::MO_RELAXED);  // Current head
+    while (!m_head.CompareExchangeWeak(h, Pack(NULL, h),
+                                       atomic::MO_ACQUIRE,
+                                       atomic::MO_RELAXED)) {
+    }
+    List ls;  // Popped list
+    C* t = Ptr(h);
+    while (t) {  // Walk the chain to rebuild the list
+      C* next = Next(*t);
+      ls.InsertTail(*t);
+      t = next;
+    }
+    return ls;
+  }
+private:
+  // Push chain [s, e]
+  void Push(C& s, C& e) {
+    uint64_t h = m_head.Load(atomic::MO_RELAXED);  // Current head
+    do {
+      SetNext(e, Ptr(h));  // Link e to current top
+    } while (!m_head.CompareExchangeWeak(h, Pack(&s, h),
+                                         atomic::MO_RELEASE,
+                                         atomic::MO_RELAXED));
+  }
+  // Get pointer from tagged head
+  static C* Ptr(uint64_t h) {
+    return (C*) (uintptr_t) (h & PTR_MASK);
+  }
+  // Pack pointer with the increased tag of old head
+  static uint64_t Pack(C* ptr, uint64_t h) {
+    return (((h >> PTR_BITS) + 1) << PTR_BITS) | (uint64_t) (uintptr_t) ptr;
+  }
+  // Next of obj, concurrent pops may read it
+  static C* Next(C& obj) {
+    return __atomic_load_n(&(obj.*F)().m_next, atomic::MO_RELAXED);
+  }
+  // Set next of obj
+  static void SetNext(C& obj, C* next) {
+    __atomic_store_n(&(obj.*F)().m_next, next, atomic::MO_RELAXED);
+  }
+  // Tagged stack head, it has its own cache line
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<uint64_t> m_head;
+};
+// Multiple producers single consumer queue (Vyukov style)
+// A producer pushes with single atomic exchange of queue tail,
+// the consumer pops without atomic read-modify-write in
+// most of the cases
+// A stub object (never returned) keeps the queue non-empty,
+// therefore C needs a default constructor
+// Note: Pop may return NULL while a producer is in the middle
+// of a push, the object becomes visible when the push finishes
+// Template arguments:
+// C - target object type
+// F - member function for getting the link node
+template<typename C, typename SLink<C>::Node& (C::*F)()>
+class MpscQueue {
+public:
+  typedef C Type;  // Type of target object
+  typedef typename SLink<C>::template List<F> List;  // Single list
+  // Default constructor
+  MpscQueue()
+    : m_head (&m_stub),
+      m_tail (&m_stub) {
+  }
+  // Deconstructor
+  ~MpscQueue() {
+  }
+  // Keep unique, no copy constructor allowed
+  MpscQueue(const MpscQueue& q) = delete;
+  // Keep unique, no assign operator allowed
+  MpscQueue& operator=(const MpscQueue& q) = delete;
+  // Push object 'obj' (producers)
+  void Push(C& obj) {
+    Push(obj, obj);
+  }
+  // Push list 'ls' with single exchange of tail (producers)
+  void Push(List&& ls) {
+    if (!ls.IsEmpty()) {
+      Push(*ls.Head(), *ls.Tail());
+      ls.Clear();
+    }
+  }
+  // Check if queue is empty (consumer)
+  bool IsEmpty() const {
+    return m_head == &m_stub && !Next(m_stub) &&
+           m_tail.Load(atomic::MO_ACQUIRE) == &m_stub;
+  }
+  // Pop queue head (consumer)
+  // Return: the popped object, NULL if queue is empty
+  C* Pop() {
+    C* head = m_head;  // Current head
+    C* next = Next(*head);  // Next of head
+    if (head == &m_stub) {  // Skip stub
+      if (!next) {  // Empty
+        return NULL;
+      }
+      m_head = next;
+      head = next;
+      next = Next(*next);
+    }
+    if (next) {  // Head is not the last one
+      return Detach(head, next);
+    }
+    // Head is the last object, or a push is in progress
+    if (m_tail.Load(atomic::MO_ACQUIRE) != head) {
+      return NULL;  // Push in progress
+    }
+    Push(m_stub);  // Push stub back, so head can be detached
+    next = Next(*head);
+    if (next) {
+      return Detach(head, next);
+    }
+    return NULL;  // Another push is in progress
+  }
+  // Pop all available objects to the tail of list 'ls' (consumer)
+  // Return: number of popped objects
+  size_t DrainTo(List& ls) {
+    size_t count = 0;  // Number of popped objects
+    while (C* obj = Pop()) {
+      ls.InsertTail(*obj);
+      ++count;
+    }
+    return count;
+  }
+private:
+  // Push chain [s, e]
+  void Push(C& s, C& e) {
+    SetNext(e, NULL);
+    C* prev = m_tail.Exchange(&e, atomic::MO_ACQ_REL);  // Swap tail
+    SetNext(*prev, &s);  // Publish to consumer
+  }
+  // Detach head from queue, next becomes new head
+  C* Detach(C* head, C* next) {
+    m_head = next;
+    SetNext(*head, NULL);  // Unlink popped object
+    return head;
+  }
+  // Next of obj, published by producers
+  static C* Next(C& obj) {
+    return __atomic_load_n(&(obj.*F)().m_next, atomic::MO_ACQUIRE);
+  }
+  // Set next of obj
+  static void SetNext(C& obj, C* next) {
+    __atomic_store_n(&(obj.*F)().m_next, next, atomic::MO_RELEASE);
+  }
+  C* m_head;  // Queue head (consumer only)
+  mutable C m_stub;  // Stub object
+  // Queue tail (producers), it has its own cache line
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<C*> m_tail;
+};
+}
+
+#endif
@@ -0,0 +1,211 @@
+// By JNI
+// Implementation of lock-free atomic bitset
+// Each bit represents a slot, slots are allocated
+// and freed by atomic or/and operations on 64-bit
+// words, so it can be used as the slot (or ID)
+// allocator shared by multiple threads
+
+#ifndef JNU_BITSET_H
+#define JNU_BITSET_H
+
+#include "jnu_defines.h"
+#include "jnu_atomic.h"
+#include "jnu_memory.h"
+
+namespace jnu {
+// Define of static bitset storage
+// Template arguments:
+// N - number of bits
+template<size_t N>
+class SBitsetDef {
+protected:
+  typedef atomic::Base<uint64_t> Word;  // Define of bit word
+  // Constructor, size and memory manager are
+  // not used by static storage
+  SBitsetDef(size_t n, memory::MMBase* mm) {
+  }
+  // Access underline words
+  Word* Words() const {
+    return (Word*) m_words;
+  }
+  // Number of bits
+  size_t Bits() const {
+    return N;
+  }
+  // Resize bitset, static storage cannot be resized
+  bool Resize(size_t n) {
+    return n == N;
+  }
+private:
+  // Words are aligned with cache line
+  alignas(JNU_CACHE_LINE_SZ) Word m_words[(N + 63) / 64];
+};
+// Define of dynamic bitset storage
+// Memory is allocated through memory manager
+class DBitsetDef {
+protected:
+  typedef atomic::Base<uint64_t> Word;  // Define of bit word
+  // Constructor
+  // Input: n - number of bits
+  //        mm - memory manager
+  DBitsetDef(size_t n, memory::MMBase* mm)
+    : m_mem (mm),
+      m_bits (0) {
+    Resize(n);
+  }
+  // Access underline words
+  Word* Words() const {
+    return (Word*) m_mem.Ptr();
+  }
+  // Number of bits
+  size_t Bits() const {
+    return m_bits;
+  }
+  // Resize bitset, words are reallocated and reset to zero
+  bool Resize(size_t n) {
+    if (m_mem.Calloc(JNU_CACHE_LINE_SZ, (n + 63) / 64, sizeof(Word))) {
+      m_bits = n;  // Update number of bits
+      return true;
+    }
+    return false;  // Allocation fail
+  }
+private:
+  memory::Mem m_mem;  // Memory of words
+  size_t m_bits;  // Number of bits
+};
+// Interface of atomic bitset
+// Allocate, Free and Test are lock-free and can be
+// called from multiple threads concurrently
+// Template arguments:
+// C - bitset storage (static or dynamic)
+template<typename C>
+class AtomicBitsetImp : private C {
+  typedef typename C::Word Word;  // Define of bit word
+  const static size_t WORD_BITS = 64;  // Bits per word
+public:
+  const static size_t NPOS = (size_t) (-1);  // Invalid slot
+  // Constructor
+  // Input: n - number of bits (only for dynamic bitset)
+  //        mm - memory manager (only for dynamic bitset)
+  AtomicBitsetImp(size_t n = 0,
+                  memory::MMBase* mm = &memory::MM_BUILDIN)
+    : C (n, mm) {
+    Reset();  // Initialize words
+  }
+  // Deconstructor
+  ~AtomicBitsetImp() {
+  }
+  // Keep unique, no copy constructor allowed
+  AtomicBitsetImp(const AtomicBitsetImp& b) = delete;
+  // Keep unique, no assign operator allowed
+  AtomicBitsetImp& operator=(const AtomicBitsetImp& b) = delete;
+  // Number of slots
+  size_t Size() const {
+    return C::Bits();
+  }
+  // Resize bitset (not thread safe)
+  // All slots become free after resize
+  bool Resize(size_t n) {
+    if (C::Resize(n)) {
+      Reset();
+      return true;
+    }
+    return false;
+  }
+  // Allocate a free slot
+  // Scan starts from the word last used by the calling
+  // thread, so threads tend to work on different words
+  // Return: index of slot, NPOS if all slots are used
+  size_t Allocate() {
+    size_t n = WordCount();  // Number of words
+    if (!n) {  // Empty bitset
+      return NPOS;
+    }
+    size_t& hint = Hint();  // Start hint of calling thread
+    size_t s = JNU_MOD(hint, n);  // Start word
+    for (size_t k = 0; k < n; ++k) {
+      size_t w = s + k < n ? s + k : s + k - n;  // Current word
+      Word& word = C::Words()[w];
+      uint64_t v = word.Load(atomic::MO_RELAXED);  // Word value
+      while (~v) {  // Has free bit
+        size_t b = __builtin_ctzll(~v);  // First free bit
+        uint64_t mask = (uint64_t) 1 << b;
+        // Set the bit, succeed if it was not set by others
+        v = word.FetchOr(mask, atomic::MO_ACQUIRE);
+        if (!(v & mask)) {
+          hint = w;  // Remember the word for next allocation
+          return w * WORD_BITS + b;
+        }
+      }
+    }
+    return NPOS;  // Full
+  }
+  // Acquire a specific slot
+  // Return: true - the slot was free and now allocated
+  bool Acquire(size_t i) {
+    if (i >= Size()) {  // Out of range
+      return false;
+    }
+    uint64_t mask = Mask(i);
+    return !(C::Words()[i / WORD_BITS].FetchOr(mask, atomic::MO_ACQUIRE)
+             & mask);
+  }
+  // Free an allocated slot
+  void Free(size_t i) {
+    if (i < Size()) {
+      C::Words()[i / WORD_BITS].FetchAnd(~Mask(i), atomic::MO_RELEASE);
+    }
+  }
+  // Check if a slot is allocated
+  bool Test(size_t i) const {
+    return i < Size() &&
+           (C::Words()[i / WORD_BITS].Load(atomic::MO_ACQUIRE) & Mask(i));
+  }
+  // Number of allocated slots (snapshot)
+  size_t Count() const {
+    size_t n = WordCount();
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+      count += __builtin_popcountll(C::Words()[i].Load(atomic::MO_RELAXED));
+    }
+    return count - (n * WORD_BITS - Size());  // Exclude padding bits
+  }
+  // Free all slots (not thread safe)
+  void Reset() {
+    size_t n = WordCount();
+    for (size_t i = 0; i < n; ++i) {
+      C::Words()[i].Store(0);
+    }
+    // Padding bits of the last word are kept as allocated
+    // so they are never returned by Allocate
+    if (size_t r = JNU_MOD(Size(), WORD_BITS)) {
+      C::Words()[n - 1].Store(~(uint64_t) 0 << r);
+    }
+  }
+private:
+  // Number of words
+  size_t WordCount() const {
+    return (Size() + WORD_BITS - 1) / WORD_BITS;
+  }
+  // Bit mask of slot i inside its word
+  static uint64_t Mask(size_t i) {
+    return (uint64_t) 1 << JNU_MOD(i, WORD_BITS);
+  }
+  // Start hint of the calling thread
+  // Initialized from the address of a thread local variable,
+  // which is different for each thread
+  static size_t& Hint() {
+    static thread_local char seed;
+    static thread_local size_t hint =
+      (size_t) (((uintptr_t) &seed >> 4) * 0x9E3779B97F4A7C15ULL >> 40);
+    return hint;
+  }
+};
+// Define of static atomic bitset
+template<size_t N>
+using AtomicBitset = AtomicBitsetImp<SBitsetDef<N>>;
+// Define of dynamic atomic bitset
+typedef AtomicBitsetImp<DBitsetDef> DAtomicBitset;
+}
+
+#endif
@@ -0,0 +1,333 @@
+// By JNI
+// Blocked Bloom filter
+// Each key sets one bit in each 64 bit word of one cache line
+// block, selected by the hash of key, so a lookup loads one
+// cache line and tests the block with a few SIMD operations
+// A filtered set keeps a filter of its keys up to date on
+// insertion and deletion, misses are answered by the filter
+// mostly, the filter is rebuilt when it is saturated, or when
+// many keys are deleted (bits of deleted keys are never
+// cleared)
+
+#ifndef JNU_BLOOM_H
+#define JNU_BLOOM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <emmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+
+namespace jnu {
+// Blocked Bloom filter
+// Template arguments:
+// K - the type of key
+// H - hash function of key
+// BITS - filter bits per key
+template<typename K, typename H = std::hash<K>, size_t BITS = 12>
+class BloomFilter {
+  const static size_t WORDS = JNU_CACHE_LINE_SZ / 8;  // Words of block
+  static_assert(WORDS == 8, "Blocks are 8 words");
+  static_assert(BITS > 0, "Bits per key must be positive");
+  typedef DArray<uint64_t, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Bits;
+public:
+  typedef K Key;  // Key type
+  // Constructor, filter has no blocks until reset
+  // Input: mm - memory manager
+  BloomFilter(memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_bits (0, mm),
+      m_blocks (0),
+      m_cap (0),
+      m_sz (0),
+      m_all (false) {
+  }
+  // Clear filter and size it for n keys
+  // A filter failed to allocate accepts all keys, so there is
+  // never a false negative
+  // Return: true - success, false - fail to allocate memory
+  bool Reset(size_t n) {
+    size_t blocks = JNU_MAX((n * BITS + 511) / 512, (size_t) 1);
+    if (blocks != m_blocks) {
+      m_bits.Clear();
+      if (!m_bits.Expand(m_bits.Begin(), blocks * WORDS)) {
+        m_blocks = 0;
+        m_cap = 0;
+        m_all = true;
+        return false;
+      }
+      m_blocks = blocks;
+    }
+    memset(m_bits.Begin(), 0, m_blocks * WORDS * 8);
+    m_cap = JNU_MAX(n, (size_t) 1);
+    m_sz = 0;
+    m_all = false;
+    return true;
+  }
+  // Clear all keys
+  void Clear() {
+    if (m_blocks) {
+      memset(m_bits.Begin(), 0, m_blocks * WORDS * 8);
+    }
+    m_sz = 0;
+  }
+  // Number of keys added
+  size_t Size() const {
+    return m_sz;
+  }
+  // Number of keys filter is sized for
+  size_t Capacity() const {
+    return m_cap;
+  }
+  // Check if more keys are added than sized for
+  bool IsSaturated() const {
+    return m_sz > m_cap;
+  }
+  // Add key
+  // Return: true - success, false - fail to allocate memory
+  bool Add(const K& key) {
+    if (!m_blocks && !Reset(WORDS)) {  // Size for a few keys
+      return false;
+    }
+    uint64_t h = Hash(key);
+    uint64_t* b = Block(h);
+    uint64_t m[WORDS];  // Bit of each word
+    Masks(h, m);
+    for (size_t i = 0; i < WORDS; ++i) {
+      b[i] |= m[i];
+    }
+    ++m_sz;
+    return true;
+  }
+  // Check if key may be added
+  // Return: false - key is never added
+  //         true - key is added, or false positive
+  bool MayContain(const K& key) const {
+    if (!m_blocks) {
+      return m_all;
+    }
+    uint64_t h = Hash(key);
+    return Test(Block(h), h);
+  }
+  // Check and add key, for deduplication
+  // Return: true - key may be added before
+  bool TestAndAdd(const K& key) {
+    bool r = MayContain(key);
+    if (!r) {
+      Add(key);
+    }
+    return r;
+  }
+private:
+  // Hash of key, mixed by 64 bit finalizer
+  static uint64_t Hash(const K& key) {
+    uint64_t h = H()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+  // Block of hash, from high 32 bits
+  uint64_t* Block(uint64_t h) const {
+    return m_bits.Begin() + ((h >> 32) * m_blocks >> 32) * WORDS;
+  }
+  // Bit positions of words, 6 bits each from remixed hash
+  static uint64_t Positions(uint64_t h) {
+    return (h * 0x9e3779b97f4a7c15ULL) >> 16;
+  }
+  // Bit masks of words
+  static void Masks(uint64_t h, uint64_t* m) {
+    uint64_t p = Positions(h);
+    for (size_t i = 0; i < WORDS; ++i) {
+      m[i] = 1ULL << ((p >> (6 * i)) & 63);
+    }
+  }
+  // Test if all bits of hash are set in block
+  static bool Test(const uint64_t* b, uint64_t h) {
+#ifdef __AVX2__
+    __m256i p = _mm256_set1_epi64x(Positions(h));
+    __m256i six = _mm256_set1_epi64x(63);
+    __m256i one = _mm256_set1_epi64x(1);
+    __m256i s0 = _mm256_and_si256(_mm256_srlv_epi64(p,
+                   _mm256_setr_epi64x(0, 6, 12, 18)), six);
+    __m256i s1 = _mm256_and_si256(_mm256_srlv_epi64(p,
+                   _mm256_setr_epi64x(24, 30, 36, 42)), six);
+    __m256i v0 = _mm256_load_si256((const __m256i*) b);
+    __m256i v1 = _mm256_load_si256((const __m256i*) (b + 4));
+    return _mm256_testc_si256(v0, _mm256_sllv_epi64(one, s0)) &
+           _mm256_testc_si256(v1, _mm256_sllv_epi64(one, s1));
+#else
+    uint64_t m[WORDS];  // Bit of each word
+    Masks(h, m);
+    __m128i all = _mm_set1_epi32(-1);  // Words with all bits set
+    for (size_t i = 0; i < WORDS; i += 2) {
+      __m128i v = _mm_load_si128((const __m128i*) (b + i));
+      __m128i k = _mm_loadu_si128((const __m128i*) (m + i));
+      all = _mm_and_si128(all, _mm_cmpeq_epi32(_mm_and_si128(v, k), k));
+    }
+    return _mm_movemask_epi8(all) == 0xffff;
+#endif
+  }
+  Bits m_bits;  // Blocks of bits
+  size_t m_blocks;  // Number of blocks
+  size_t m_cap;  // Number of keys sized for
+  size_t m_sz;  // Number of keys added
+  bool m_all;  // Accept all keys, failed to allocate
+};
+// Sorted set with Bloom filter of its keys
+// Template arguments:
+// S - the set type (ArraySetT)
+// H - hash function of key
+// BITS - filter bits per key
+template<typename S, typename H = std::hash<typename S::Key>,
+         size_t BITS = 12>
+class BloomSet {
+  typedef typename S::Type T;  // Element type
+  typedef typename S::Key K;  // Key type
+public:
+  typedef T Type;  // Element type
+  typedef K Key;  // Key type
+  typedef typename S::Res Res;  // Search or insertion result
+  typedef BloomFilter<K, H, BITS> Filter;  // Filter type
+  // Constructor
+  // Input: mm - memory manager of set and filter
+  BloomSet(memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_set (0, mm),
+      m_filter (mm),
+      m_deleted (0) {
+  }
+  // Get underline set, which must not be modified directly
+  const S& Set() const {
+    return m_set;
+  }
+  // Get filter
+  const Filter& GetFilter() const {
+    return m_filter;
+  }
+  // Get set size
+  size_t Size() const {
+    return m_set.Size();
+  }
+  // Check if set is empty
+  bool IsEmpty() const {
+    return m_set.IsEmpty();
+  }
+  // Clear set and filter
+  void Clear() {
+    m_set.Clear();
+    m_filter.Clear();
+    m_deleted = 0;
+  }
+  // Insert element, existing element is untouched
+  template<typename... Hints>
+  Res Insert(const T& t, Hints... hints) {
+    return Added(m_set.Insert(t, hints...));
+  }
+  // Insert element, existing element is replaced
+  template<typename... Hints>
+  Res ReplaceInsert(const T& t, Hints... hints) {
+    return Added(m_set.ReplaceInsert(t, hints...));
+  }
+  // Inject (move) element, existing element is untouched
+  template<typename... Hints>
+  Res Inject(T& t, Hints... hints) {
+    return Added(m_set.Inject(t, hints...));
+  }
+  // Inject (move) element, existing element is replaced
+  template<typename... Hints>
+  Res ReplaceInject(T& t, Hints... hints) {
+    return Added(m_set.ReplaceInject(t, hints...));
+  }
+  // Insert (unsorted) array of data
+  // Return: true - insert successful (of set, filter accepts
+  //         all keys if it fails to allocate memory)
+  template<typename... Hints>
+  bool Insert(const T* t, size_t t_sz, Hints... hints) {
+    bool r = m_set.Insert(t, t_sz, hints...);
+    Added(t, t_sz);
+    return r;
+  }
+  // Insert (unsorted) array of data, replace existing
+  template<typename... Hints>
+  bool ReplaceInsert(const T* t, size_t t_sz, Hints... hints) {
+    bool r = m_set.ReplaceInsert(t, t_sz, hints...);
+    Added(t, t_sz);
+    return r;
+  }
+  // Delete key
+  // Return: true - key found and deleted
+  bool Delete(const K& key) {
+    T* p = Find(key);
+    if (!p) {
+      return false;
+    }
+    m_set.Delete(p, 1);
+    // Rebuild when deleted keys are a quarter of filter
+    if (++m_deleted > m_filter.Size() / 4 + 8) {
+      Rebuild();
+    }
+    return true;
+  }
+  // Locate key
+  // Return: the location of key,
+  //         if not found, the location the key should
+  //         be inserted
+  template<typename... Hints>
+  Res Locate(const K& key, Hints... hints) const {
+    return m_set.Locate(key, hints...);
+  }
+  // Find key, misses are mostly answered by filter
+  // Return: the location if found
+  //         invalid location if not found
+  template<typename... Hints>
+  T* Find(const K& key, Hints... hints) const {
+    return m_filter.MayContain(key) ? m_set.Find(key, hints...) : NULL;
+  }
+  // Rebuild filter of all keys, sized for twice set size
+  // Return: true - success, false - fail to allocate memory
+  bool Rebuild() {
+    if (!m_filter.Reset(2 * m_set.Size())) {
+      return false;
+    }
+    for (const T* p = m_set.Begin(); p < m_set.End(); ++p) {
+      m_filter.Add(S::KeyOf(*p));
+    }
+    m_deleted = 0;
+    return true;
+  }
+private:
+  // Add key of inserted element to filter
+  Res Added(const Res& r) {
+    if (r && r.Inserted()) {
+      if (m_filter.Size() >= m_filter.Capacity()) {
+        Rebuild();  // Saturated, includes new key
+      } else {
+        m_filter.Add(S::KeyOf(**r));
+      }
+    }
+    return r;
+  }
+  // Add keys of inserted array to filter, keys already in
+  // filter (existing elements mostly) are not added again,
+  // filter is rebuilt if saturated
+  void Added(const T* t, size_t t_sz) {
+    for (size_t i = 0; i < t_sz; ++i) {
+      m_filter.TestAndAdd(S::KeyOf(t[i]));
+    }
+    if (m_filter.IsSaturated()) {
+      Rebuild();
+    }
+  }
+  S m_set;  // Underline set
+  Filter m_filter;  // Filter of keys
+  size_t m_deleted;  // Keys deleted since rebuild
+};
+}
+
+#endif
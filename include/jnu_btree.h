@@ -0,0 +1,741 @@
+// By JNI
+// B+tree sorted set
+// Leaves are sorted sets on static arrays of a few cache
+// lines, linked in key order, inner nodes are static arrays
+// of keys and child pointers, so an insertion or deletion
+// shifts one node only instead of the whole set
+// Each inner key is an upper bound of keys in its child (the
+// last key of the child when it is split), children are
+// routed by counting inner keys less than searched key,
+// which is vectorized for arithmetic keys
+// Nodes are allocated through memory manager, and rebalanced
+// (borrowed from or merged with siblings) on deletion
+// The interface is the one of ArraySetT for insertion, search
+// and deletion, hints are accepted and ignored, differences:
+// search keys are of key type, Delete of [p, p + t_sz) takes
+// elements in key order across leaves and returns NULL at the
+// end of set, and there is no continuous Begin/End, elements
+// are iterated by ForEach
+
+#ifndef JNU_BTREE_H
+#define JNU_BTREE_H
+
+#include <new>
+#include <utility>
+#include <type_traits>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_array_set.h"
+#include "jnu_search.h"
+
+namespace jnu {
+// B+tree sorted set
+// Template arguments:
+// C - the array data type, of element type and allocation
+//     model of elements (leaves are static arrays of them)
+// K - the type of key
+// KEY - the function for getting key from underline objects
+// LESS - comparison of key (less than)
+// LN - maximum elements of a leaf
+// IN - maximum children of an inner node
+template<typename C, typename K,
+         auto KEY = (const K& (*)(const typename C::Type)) NULL,
+         auto LESS = (bool (*) (const K&, const K&)) NULL,
+         size_t LN = JNU_MAX(8, 4 * JNU_CACHE_LINE_SZ /
+                                sizeof(typename C::Type)),
+         size_t IN = JNU_MAX(8, 4 * JNU_CACHE_LINE_SZ / sizeof(K))>
+class BTreeSetT {
+  static_assert(LN >= 4 && IN >= 4, "Nodes are too small");
+  typedef typename C::Type T;  // Underline data type
+  typedef ArraySetT<SArray<T, LN, typename C::Alloc>,
+                    K, KEY, LESS> LeafSet;
+  // Plain keys are copied as memory
+  typedef typename std::conditional<std::is_trivially_copyable<K>::value,
+                                    ARR_MEM_ALLOC,
+                                    ARR_OBJ_ALLOC>::type KA;
+  const static size_t MIN_LEAF = LN / 2;  // Minimum leaf elements
+  const static size_t MIN_INNER = IN / 2;  // Minimum inner children
+  const static size_t MAX_DEPTH = 32;  // Maximum tree height
+  // Base of nodes, type is known by level
+  struct Node {
+  };
+  // Leaf node
+  struct Leaf : Node {
+    // Constructor
+    Leaf(memory::MMBase* mm)
+      : m_set (0, mm),
+        m_prev (NULL),
+        m_next (NULL) {
+    }
+    LeafSet m_set;  // Sorted elements
+    Leaf* m_prev;  // Previous leaf in key order
+    Leaf* m_next;  // Next leaf in key order
+  };
+  // Inner node
+  struct Inner : Node {
+    // Constructor
+    Inner(memory::MMBase* mm)
+      : m_keys (0, mm),
+        m_child (0, mm) {
+    }
+    SArray<K, IN - 1, KA> m_keys;  // Upper bound keys of children
+    SArray<Node*, IN, ARR_MEM_ALLOC> m_child;  // Children
+  };
+  // Path from root to leaf
+  struct Path {
+    Inner* m_node[MAX_DEPTH];  // Inner nodes
+    size_t m_idx[MAX_DEPTH];  // Child index taken
+    size_t m_depth;  // Number of inner nodes
+  };
+public:
+  typedef T Type;  // Underline data type
+  typedef K Key;  // Key type
+  // Search or insertion result structure
+  class Res {
+    friend class BTreeSetT;
+  public:
+    // Get element, valid until next modification
+    T* operator*() const {
+      return m_it;
+    }
+    // Check if valid
+    operator bool() const {
+      return m_it != NULL;
+    }
+    // For insertion, check if data inserted
+    bool Inserted() const {
+      return !m_found;
+    }
+    // For searching, check if data found
+    bool Found() const {
+      return m_found;
+    }
+  private:
+    // Constructor
+    Res(T* it = NULL, bool found = false)
+      : m_it (it),
+        m_found (found) {
+    }
+    T* m_it;  // Element
+    bool m_found;  // Flag for data found
+  };
+  // Constructor, nodes are allocated on demand, so there is
+  // nothing to reserve
+  // Input: rsv_sz - reserved size (ignored)
+  //        mm - memory manager (use buildin as default)
+  BTreeSetT(size_t rsv_sz = 0,
+            memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_mm (mm),
+      m_root (NULL),
+      m_head (NULL),
+      m_height (0),
+      m_size (0) {
+  }
+  // Deconstructor
+  ~BTreeSetT() {
+    Clear();
+  }
+  // Keep unique, no copy constructor allowed
+  BTreeSetT(const BTreeSetT& s) = delete;
+  // Keep unique, no assign operator allowed
+  BTreeSetT& operator=(const BTreeSetT& s) = delete;
+  // Get key of element
+  static const K& KeyOf(const T& t) {
+    return LeafSet::KeyOf(t);
+  }
+  // Get set size
+  size_t Size() const {
+    return m_size;
+  }
+  // Check if set is empty
+  bool IsEmpty() const {
+    return m_size <= 0;
+  }
+  // Number of levels (0 for empty tree)
+  size_t Height() const {
+    return m_height;
+  }
+  // Clear set and free all nodes
+  void Clear() {
+    if (m_root) {
+      FreeTree(m_root, m_height);
+    }
+    m_root = NULL;
+    m_head = NULL;
+    m_height = 0;
+    m_size = 0;
+  }
+  // Locate key
+  // Return: the location of key,
+  //         if not found, the location the key should
+  //         be inserted in its leaf
+  template<typename... Hints>
+  Res Locate(const K& key, Hints...) const {
+    if (!m_root) {
+      return Res();
+    }
+    Path path;
+    typename LeafSet::Res r = Descend(key, path)->m_set.Locate(key);
+    return Res(*r, r.Found());
+  }
+  // Find key
+  // Return: the location if found
+  //         invalid location if not found
+  template<typename... Hints>
+  T* Find(const K& key, Hints...) const {
+    Res r = Locate(key);
+    return r.Found() ? *r : NULL;
+  }
+  // No replace insert single element
+  // Return: insert result, including
+  //         the position of insertion and if
+  //         the element already exists
+  template<typename... Hints>
+  Res Insert(const T& t, Hints...) {
+    return Add<const T, false>(t);
+  }
+  // Replace insert single element
+  template<typename... Hints>
+  Res ReplaceInsert(const T& t, Hints...) {
+    return Add<const T, true>(t);
+  }
+  // No replace inject (move) single element
+  template<typename... Hints>
+  Res Inject(T& t, Hints...) {
+    return Add<T, false>(t);
+  }
+  // Replace inject single element
+  template<typename... Hints>
+  Res ReplaceInject(T& t, Hints...) {
+    return Add<T, true>(t);
+  }
+  // No replace insert (unsorted) array of data
+  // Return: true - insert successful
+  template<typename... Hints>
+  bool Insert(const T* t, size_t t_sz, Hints...) {
+    return Each<const T, false>(t, t_sz);
+  }
+  // Replace insert (unsorted) array of data
+  template<typename... Hints>
+  bool ReplaceInsert(const T* t, size_t t_sz, Hints...) {
+    return Each<const T, true>(t, t_sz);
+  }
+  // No replace insert array [t, t_end)
+  template<typename... Hints>
+  bool Insert(const T* t, const T* t_end, Hints...) {
+    return Insert(t, (size_t) (t_end - t));
+  }
+  // Replace insert array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInsert(const T* t, const T* t_end, Hints...) {
+    return ReplaceInsert(t, (size_t) (t_end - t));
+  }
+  // No replace insert sorted array, each element is added
+  // down from root, the same as an unsorted array
+  template<typename... Hints>
+  bool InsertSorted(const T* t, size_t t_sz, Hints...) {
+    return Insert(t, t_sz);
+  }
+  // Replace insert sorted array
+  template<typename... Hints>
+  bool ReplaceInsertSorted(const T* t, size_t t_sz, Hints...) {
+    return ReplaceInsert(t, t_sz);
+  }
+  // No replace insert sorted array [t, t_end)
+  template<typename... Hints>
+  bool InsertSorted(const T* t, const T* t_end, Hints...) {
+    return Insert(t, (size_t) (t_end - t));
+  }
+  // Replace insert sorted array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInsertSorted(const T* t, const T* t_end, Hints...) {
+    return ReplaceInsert(t, (size_t) (t_end - t));
+  }
+  // No replace inject (unsorted) array
+  // Elements in array will be moved to set
+  template<typename... Hints>
+  bool Inject(T* t, size_t t_sz, Hints...) {
+    return Each<T, false>(t, t_sz);
+  }
+  // Replace inject (unsorted) array
+  template<typename... Hints>
+  bool ReplaceInject(T* t, size_t t_sz, Hints...) {
+    return Each<T, true>(t, t_sz);
+  }
+  // No replace inject array [t, t_end)
+  template<typename... Hints>
+  bool Inject(T* t, T* t_end, Hints...) {
+    return Inject(t, (size_t) (t_end - t));
+  }
+  // Replace inject array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInject(T* t, T* t_end, Hints...) {
+    return ReplaceInject(t, (size_t) (t_end - t));
+  }
+  // No replace inject sorted array
+  template<typename... Hints>
+  bool InjectSorted(T* t, size_t t_sz, Hints...) {
+    return Inject(t, t_sz);
+  }
+  // Replace inject sorted array
+  template<typename... Hints>
+  bool ReplaceInjectSorted(T* t, size_t t_sz, Hints...) {
+    return ReplaceInject(t, t_sz);
+  }
+  // No replace inject sorted array [t, t_end)
+  template<typename... Hints>
+  bool InjectSorted(T* t, T* t_end, Hints...) {
+    return Inject(t, (size_t) (t_end - t));
+  }
+  // Replace inject sorted array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInjectSorted(T* t, T* t_end, Hints...) {
+    return ReplaceInject(t, (size_t) (t_end - t));
+  }
+  // No replace inject array of arr
+  // The input array will be cleared after inject
+  template<typename H, typename... Hints>
+  bool Inject(H& arr, T* t, size_t t_sz, Hints...) {
+    return Cleared(arr, t, t_sz, Inject(t, t_sz));
+  }
+  // Replace inject array of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInject(H& arr, T* t, size_t t_sz, Hints...) {
+    return Cleared(arr, t, t_sz, ReplaceInject(t, t_sz));
+  }
+  // No replace inject array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool Inject(H& arr, T* t, T* t_end, Hints...) {
+    return Inject(arr, t, (size_t) (t_end - t));
+  }
+  // Replace inject array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInject(H& arr, T* t, T* t_end, Hints...) {
+    return ReplaceInject(arr, t, (size_t) (t_end - t));
+  }
+  // No replace inject sorted array of arr
+  template<typename H, typename... Hints>
+  bool InjectSorted(H& arr, T* t, size_t t_sz, Hints...) {
+    return Inject(arr, t, t_sz);
+  }
+  // Replace inject sorted array of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInjectSorted(H& arr, T* t, size_t t_sz, Hints...) {
+    return ReplaceInject(arr, t, t_sz);
+  }
+  // No replace inject sorted array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool InjectSorted(H& arr, T* t, T* t_end, Hints...) {
+    return Inject(arr, t, (size_t) (t_end - t));
+  }
+  // Replace inject sorted array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInjectSorted(H& arr, T* t, T* t_end, Hints...) {
+    return ReplaceInject(arr, t, (size_t) (t_end - t));
+  }
+  // Delete elements [p, p + t_sz) in key order, p is a
+  // location found in the set
+  // Return: the location after deleted elements, valid until
+  //         next modification, NULL at end of set
+  T* Delete(T* p, size_t t_sz) {
+    for (; p && t_sz > 0; --t_sz) {
+      Erase(KeyOf(*p), &p);
+    }
+    return p;
+  }
+  // Delete elements [p, p_end) of one leaf
+  T* Delete(T* p, const T* p_end) {
+    return Delete(p, (size_t) (p_end - p));
+  }
+  // Delete key
+  // Return: true - key found and deleted
+  bool Delete(const K& key) {
+    return Erase(key, NULL);
+  }
+  // Iterate elements in key order
+  // Input: f - function called as f(T&)
+  template<typename H>
+  void ForEach(H f) const {
+    for (Leaf* l = m_head; l; l = l->m_next) {
+      for (T* p = l->m_set.Begin(); p < l->m_set.End(); ++p) {
+        f(*p);
+      }
+    }
+  }
+private:
+  // Allocate node
+  template<typename N>
+  N* New() {
+    void* p = m_mm->Malloc(JNU_CACHE_LINE_SZ, sizeof(N));
+    return p ? ::new (p) N(m_mm) : NULL;
+  }
+  // Free node
+  template<typename N>
+  void Release(N* n) {
+    n->~N();
+    m_mm->Free(n);
+  }
+  // Free subtree of level h (1 for leaf)
+  void FreeTree(Node* n, size_t h) {
+    if (h <= 1) {
+      Release(static_cast<Leaf*>(n));
+      return;
+    }
+    Inner* in = static_cast<Inner*>(n);
+    for (size_t i = 0; i < in->m_child.Size(); ++i) {
+      FreeTree(in->m_child[i], h - 1);
+    }
+    Release(in);
+  }
+  // Less comparison of keys
+  static bool Less(const K& a, const K& b) {
+    return LeafSet::KeyLess(a, b);
+  }
+  // Child of inner node covering key
+  static size_t Route(const Inner* n, const K& key) {
+    const K* k = n->m_keys.Begin();
+    size_t sz = n->m_keys.Size();
+    if constexpr (std::is_arithmetic<K>::value && LESS == NULL) {
+      return search::CountLess(k, sz, key);  // Vectorized
+    }
+    size_t lo = 0;  // Binary search
+    while (lo < sz) {
+      size_t mid = lo + (sz - lo) / 2;
+      if (Less(k[mid], key)) {
+        lo = mid + 1;
+      } else {
+        sz = mid;
+      }
+    }
+    return lo;
+  }
+  // Descend from root to leaf covering key
+  Leaf* Descend(const K& key, Path& path) const {
+    Node* n = m_root;
+    path.m_depth = 0;
+    for (size_t h = m_height; h > 1; --h) {
+      Inner* in = static_cast<Inner*>(n);
+      size_t i = Route(in, key);
+      path.m_node[path.m_depth] = in;
+      path.m_idx[path.m_depth++] = i;
+      n = in->m_child[i];
+    }
+    return static_cast<Leaf*>(n);
+  }
+  // Add element
+  // Template arguments:
+  // H - const T for copy, T for move
+  // R - replace existing element
+  template<typename H, bool R>
+  Res Add(H& t) {
+    const K& key = KeyOf(t);
+    if (!m_root) {  // First leaf
+      m_head = New<Leaf>();
+      if (!m_head) {
+        return Res();
+      }
+      m_root = m_head;
+      m_height = 1;
+    }
+    Path path;
+    Leaf* leaf = Descend(key, path);
+    typename LeafSet::Res r = leaf->m_set.Locate(key);
+    if (r.Found()) {
+      if constexpr (R) {
+        *(*r) = std::move(t);
+      }
+      return Res(*r, true);
+    }
+    size_t pos = *r - leaf->m_set.Begin();  // Insert position
+    if (leaf->m_set.Size() >= LN) {  // Split full leaf
+      Leaf* right = Split(leaf, path);
+      if (!right) {
+        return Res();
+      }
+      if (pos >= LN / 2) {  // Key after last key of left
+        leaf = right;
+        pos -= LN / 2;
+      }
+    }
+    T* p = leaf->m_set.Begin() + pos;
+    if constexpr (std::is_const<H>::value) {
+      p = leaf->m_set.Data().Insert(p, t, 1);
+    } else {
+      p = leaf->m_set.Data().Inject(p, &t, 1);
+    }
+    m_size += p != NULL;
+    return Res(p, false);
+  }
+  // Add elements of array one by one
+  template<typename H, bool R>
+  bool Each(H* t, size_t t_sz) {
+    for (size_t i = 0; i < t_sz; ++i) {
+      if (!Add<H, R>(t[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Clear injected elements of arr
+  template<typename H>
+  static bool Cleared(H& arr, T* t, size_t t_sz, bool injected) {
+    if (injected) {
+      arr.Delete(t, t_sz);
+    }
+    return injected;
+  }
+  // Delete key, and rebalance nodes
+  // Input: key - key to delete, not used after the element
+  //              is deleted (it may be the key of element)
+  //        next - set to the location after deleted element,
+  //               NULL at end of set, if not NULL
+  // Return: true - key found and deleted
+  bool Erase(const K& key, T** next) {
+    if (!m_root) {
+      return false;
+    }
+    Path path;
+    Leaf* leaf = Descend(key, path);
+    T* p = leaf->m_set.Find(key);
+    if (!p) {
+      return false;
+    }
+    leaf->m_set.Delete(p, 1);
+    --m_size;
+    T* q = p < leaf->m_set.End() ? p :  // Next element
+           leaf->m_next ? leaf->m_next->m_set.Begin() : NULL;
+    if (next && q && path.m_depth &&
+        Underflow(leaf, path.m_depth)) {  // Moved by rebalance
+      K k = KeyOf(*q);
+      Rebalance(leaf, path);
+      q = Find(k);
+    } else {
+      Rebalance(leaf, path);
+    }
+    if (next) {
+      *next = q;
+    }
+    return true;
+  }
+  // Rebalance under filled nodes upward from leaf
+  void Rebalance(Leaf* leaf, const Path& path) {
+    Node* n = leaf;
+    for (size_t d = path.m_depth; d > 0 && Underflow(n, d); --d) {
+      Inner* parent = path.m_node[d - 1];
+      if (d == path.m_depth) {
+        FixLeaf(parent, path.m_idx[d - 1]);
+      } else {
+        FixInner(parent, path.m_idx[d - 1]);
+      }
+      n = parent;
+    }
+    Shrink();
+  }
+  // Split full leaf, and full inner nodes upward
+  // Nodes are allocated first, so tree is untouched on failure
+  // Return: the new right leaf
+  Leaf* Split(Leaf* leaf, Path& path) {
+    size_t d = path.m_depth;  // Full inner nodes above leaf
+    while (d > 0 && path.m_node[d - 1]->m_child.Size() >= IN) {
+      --d;
+    }
+    size_t n = path.m_depth - d + (d == 0);  // Inner nodes needed
+    if (m_height + (d == 0) > MAX_DEPTH) {
+      return NULL;
+    }
+    Inner* spare[MAX_DEPTH];  // New inner nodes
+    Leaf* right = New<Leaf>();
+    size_t got = 0;  // Allocated inner nodes
+    while (right && got < n && (spare[got] = New<Inner>())) {
+      ++got;
+    }
+    if (!right || got < n) {  // Release on failure
+      for (size_t i = 0; i < got; ++i) {
+        Release(spare[i]);
+      }
+      if (right) {
+        Release(right);
+      }
+      return NULL;
+    }
+    // Move upper half to right leaf
+    typename LeafSet::Type* mid = leaf->m_set.Begin() + LN / 2;
+    right->m_set.Data().Inject(right->m_set.End(), mid, LN - LN / 2);
+    leaf->m_set.Delete(mid, LN - LN / 2);
+    right->m_next = leaf->m_next;
+    right->m_prev = leaf;
+    if (leaf->m_next) {
+      leaf->m_next->m_prev = right;
+    }
+    leaf->m_next = right;
+    // Insert separator and right node upward
+    K sep = KeyOf(leaf->m_set.End()[-1]);
+    Node* node = right;
+    for (d = path.m_depth; d > 0; --d) {
+      Inner* in = path.m_node[d - 1];
+      size_t i = path.m_idx[d - 1];
+      if (in->m_child.Size() < IN) {
+        Put(in, i, sep, node);
+        return right;
+      }
+      Inner* q = spare[--n];  // Split full inner node
+      size_t h = IN / 2;  // Children left in node
+      q->m_keys.Insert(q->m_keys.End(), in->m_keys.Begin() + h,
+                       in->m_keys.Size() - h);
+      q->m_child.Insert(q->m_child.End(), in->m_child.Begin() + h,
+                        IN - h);
+      K up = in->m_keys[h - 1];  // Upper bound of node
+      in->m_keys.Delete(in->m_keys.Begin() + h - 1, IN - h);
+      in->m_child.Delete(in->m_child.Begin() + h, IN - h);
+      if (i < h) {
+        Put(in, i, sep, node);
+      } else {
+        Put(q, i - h, sep, node);
+      }
+      sep = std::move(up);
+      node = q;
+    }
+    Inner* root = spare[--n];  // Grow new root
+    root->m_keys.Insert(root->m_keys.End(), sep, 1);
+    root->m_child.Insert(root->m_child.End(), m_root, 1);
+    root->m_child.Insert(root->m_child.End(), node, 1);
+    m_root = root;
+    ++m_height;
+    return right;
+  }
+  // Insert separator after child i, and its right node
+  static void Put(Inner* in, size_t i, const K& sep, Node* node) {
+    in->m_keys.Insert(in->m_keys.Begin() + i, sep, 1);
+    in->m_child.Insert(in->m_child.Begin() + i + 1, node, 1);
+  }
+  // Check if node of path depth d is under filled
+  bool Underflow(Node* n, size_t d) const {
+    return d == m_height - 1 ?
+           static_cast<Leaf*>(n)->m_set.Size() < MIN_LEAF :
+           static_cast<Inner*>(n)->m_child.Size() < MIN_INNER;
+  }
+  // Get leaf child i
+  static Leaf* LeafAt(Inner* in, size_t i) {
+    return static_cast<Leaf*>(in->m_child[i]);
+  }
+  // Get inner child i
+  static Inner* InnerAt(Inner* in, size_t i) {
+    return static_cast<Inner*>(in->m_child[i]);
+  }
+  // Fix under filled leaf child i of parent
+  void FixLeaf(Inner* parent, size_t i) {
+    LeafSet& s = LeafAt(parent, i)->m_set;
+    size_t n = parent->m_child.Size();
+    if (i > 0 && LeafAt(parent, i - 1)->m_set.Size() > MIN_LEAF) {
+      LeafSet& l = LeafAt(parent, i - 1)->m_set;  // Borrow from left
+      s.Data().Inject(s.Begin(), l.End() - 1, 1);
+      l.Delete(l.End() - 1, 1);
+      parent->m_keys[i - 1] = KeyOf(l.End()[-1]);
+    } else if (i + 1 < n &&
+               LeafAt(parent, i + 1)->m_set.Size() > MIN_LEAF) {
+      LeafSet& r = LeafAt(parent, i + 1)->m_set;  // Borrow from right
+      s.Data().Inject(s.End(), r.Begin(), 1);
+      r.Delete(r.Begin(), 1);
+      parent->m_keys[i] = KeyOf(s.End()[-1]);
+    } else {  // Merge with a sibling
+      MergeLeaf(parent, i > 0 ? i - 1 : i);
+    }
+  }
+  // Merge leaf child i + 1 into child i
+  void MergeLeaf(Inner* parent, size_t i) {
+    Leaf* l = LeafAt(parent, i);
+    Leaf* r = LeafAt(parent, i + 1);
+    l->m_set.Data().Inject(l->m_set.End(), r->m_set.Begin(),
+                           r->m_set.Size());
+    l->m_next = r->m_next;
+    if (r->m_next) {
+      r->m_next->m_prev = l;
+    }
+    parent->m_keys.Delete(parent->m_keys.Begin() + i, 1);
+    parent->m_child.Delete(parent->m_child.Begin() + i + 1, 1);
+    Release(r);
+  }
+  // Fix under filled inner child i of parent
+  void FixInner(Inner* parent, size_t i) {
+    Inner* c = InnerAt(parent, i);
+    size_t n = parent->m_child.Size();
+    if (i > 0 && InnerAt(parent, i - 1)->m_child.Size() > MIN_INNER) {
+      Inner* l = InnerAt(parent, i - 1);  // Borrow from left
+      c->m_keys.Insert(c->m_keys.Begin(), parent->m_keys[i - 1], 1);
+      c->m_child.Insert(c->m_child.Begin(), l->m_child.End()[-1], 1);
+      parent->m_keys[i - 1] = l->m_keys.End()[-1];
+      l->m_keys.Delete(l->m_keys.End() - 1, 1);
+      l->m_child.Delete(l->m_child.End() - 1, 1);
+    } else if (i + 1 < n &&
+               InnerAt(parent, i + 1)->m_child.Size() > MIN_INNER) {
+      Inner* r = InnerAt(parent, i + 1);  // Borrow from right
+      c->m_keys.Insert(c->m_keys.End(), parent->m_keys[i], 1);
+      c->m_child.Insert(c->m_child.End(), r->m_child[0], 1);
+      parent->m_keys[i] = r->m_keys[0];
+      r->m_keys.Delete(r->m_keys.Begin(), 1);
+      r->m_child.Delete(r->m_child.Begin(), 1);
+    } else {  // Merge with a sibling
+      MergeInner(parent, i > 0 ? i - 1 : i);
+    }
+  }
+  // Merge inner child i + 1 into child i
+  void MergeInner(Inner* parent, size_t i) {
+    Inner* l = InnerAt(parent, i);
+    Inner* r = InnerAt(parent, i + 1);
+    l->m_keys.Insert(l->m_keys.End(), parent->m_keys[i], 1);
+    l->m_keys.Insert(l->m_keys.End(), r->m_keys.Begin(),
+                     r->m_keys.Size());
+    l->m_child.Insert(l->m_child.End(), r->m_child.Begin(),
+                      r->m_child.Size());
+    parent->m_keys.Delete(parent->m_keys.Begin() + i, 1);
+    parent->m_child.Delete(parent->m_child.Begin() + i + 1, 1);
+    Release(r);
+  }
+  // Remove roots with single child, and empty root leaf
+  void Shrink() {
+    while (m_height > 1 &&
+           static_cast<Inner*>(m_root)->m_child.Size() == 1) {
+      Inner* old = static_cast<Inner*>(m_root);
+      m_root = old->m_child[0];
+      Release(old);
+      --m_height;
+    }
+    if (m_height == 1 && static_cast<Leaf*>(m_root)->m_set.IsEmpty()) {
+      Release(static_cast<Leaf*>(m_root));
+      m_root = NULL;
+      m_head = NULL;
+      m_height = 0;
+    }
+  }
+  memory::MMBase* m_mm;  // Memory manager
+  Node* m_root;  // Root node
+  Leaf* m_head;  // First leaf
+  size_t m_height;  // Number of levels
+  size_t m_size;  // Number of elements
+};
+// B+tree set (underline element as key)
+// C - array type of elements
+// LESS - Comparison of element
+// LN - maximum elements of a leaf
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type&,
+                                const typename C::Type&)) NULL,
+         size_t LN = JNU_MAX(8, 4 * JNU_CACHE_LINE_SZ /
+                                sizeof(typename C::Type))>
+using BTreeSet = BTreeSetT<C, typename C::Type,
+                           (const typename C::Type& (*)
+                           (const typename C::Type)) NULL,
+                           LESS, LN>;
+// B+tree map (element is a pair object)
+// Using first object as key
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type::FirstType&,
+                                const typename C::Type::FirstType&)) NULL,
+         size_t LN = JNU_MAX(8, 4 * JNU_CACHE_LINE_SZ /
+                                sizeof(typename C::Type))>
+using BTreeMap = BTreeSetT<C, typename C::Type::FirstType,
+                           C::Type::GetFirst, LESS, LN>;
+}
+
+#endif
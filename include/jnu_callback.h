@@ -6,6 +6,9 @@
 #ifndef JNU_CALLBACK_H
 #define JNU_CALLBACK_H
 
+#include <stddef.h>
+#include <new>
+#include <utility>
 #include <type_traits>
 
 namespace jnu {
@@ -284,6 +287,112 @@ private:
   C m_obj;  // Underline object
   FType m_func;  // Underline member function
 };
+// Type erased callable without arguments
+// The callable is constructed in a small inline buffer, so
+// creating a task never allocates, callable larger than the
+// buffer fails to compile
+// Task is movable but not copyable
+// template parameter: S - size of inline buffer
+template<size_t S>
+class TaskT {
+  // Decayed type of callable
+  template<typename F>
+  using DType = typename std::decay<F>::type;
+  // Enable if F is not task itself
+  template<typename F>
+  using NTask = typename std::enable_if<
+                  !std::is_same<DType<F>, TaskT>::value>::type;
+  // Operations on stored callable
+  struct Ops {
+    void (*m_run)(void*);  // Invoke
+    void (*m_move)(void*, void*);  // Move construct (dst, src)
+    void (*m_destroy)(void*);  // Destroy
+  };
+  // Operations of callable type F
+  template<typename F>
+  struct OpsT {
+    static void Run(void* p) {
+      (*(F*) p)();
+    }
+    static void Move(void* dst, void* src) {
+      new (dst) F(std::move(*(F*) src));
+    }
+    static void Destroy(void* p) {
+      ((F*) p)->~F();
+    }
+    static constexpr Ops OPS = {Run, Move, Destroy};
+  };
+public:
+  const static size_t BUF_SZ = S;  // Inline buffer size
+  // Default constructor
+  TaskT()
+    : m_ops (NULL) {
+  }
+  // Constructor with callable
+  template<typename F, typename = NTask<F>>
+  TaskT(F&& f)
+    : m_ops (NULL) {
+    Set(std::forward<F>(f));
+  }
+  // Deconstructor
+  ~TaskT() {
+    Reset();
+  }
+  // Keep unique, no copy constructor allowed
+  TaskT(const TaskT& t) = delete;
+  // Keep unique, no assign operator allowed
+  TaskT& operator=(const TaskT& t) = delete;
+  // Move constructor
+  TaskT(TaskT&& t)
+    : m_ops (NULL) {
+    *this = std::move(t);
+  }
+  // Move operator
+  TaskT& operator=(TaskT&& t) {
+    if (this != &t) {
+      Reset();
+      if (t.m_ops) {  // Move callable and clear input
+        t.m_ops->m_move(m_buf, t.m_buf);
+        m_ops = t.m_ops;
+        t.Reset();
+      }
+    }
+    return *this;
+  }
+  // Set callable
+  template<typename F>
+  void Set(F&& f) {
+    typedef DType<F> T;  // Stored type
+    static_assert(sizeof(T) <= S, "callable is too large for task");
+    static_assert(alignof(T) <= alignof(max_align_t),
+                  "callable is over aligned for task");
+    Reset();
+    new (m_buf) T(std::forward<F>(f));
+    m_ops = &OpsT<T>::OPS;
+  }
+  // Destroy callable
+  void Reset() {
+    if (m_ops) {
+      m_ops->m_destroy(m_buf);
+      m_ops = NULL;
+    }
+  }
+  // Bool operator, check if callable is set
+  operator bool() const {
+    return m_ops;
+  }
+  // Invoke callable (if set)
+  void operator()() {
+    if (m_ops) {
+      m_ops->m_run(m_buf);
+    }
+  }
+private:
+  alignas(max_align_t) char m_buf[S];  // Inline buffer
+  const Ops* m_ops;  // Operations of stored callable
+};
+// Define of default task, fits in one cache line
+typedef TaskT<48> Task;
 }
 
 #endif
@@ -0,0 +1,410 @@
+// By JNI
+// Compressed sorted set of unsigned integers
+// Elements are stored in blocks of 128, each block keeps its
+// first element as base and the deltas of elements from the
+// element 4 positions before (the first 4 from base), so 4
+// lanes are decoded by one vector addition (D4 deltas)
+// Deltas are bit-packed with the width of the block chosen to
+// minimize its size, deltas exceeding the width keep their
+// high bits as exceptions which are patched after unpacking
+// (patched frame of reference)
+// Lane i of a block takes elements i, i + 4, ..., each lane
+// is a bit stream of words, and words of lanes are
+// interleaved, so 32 bit blocks are unpacked 4 lanes a time
+// by SSE2
+// Maxima of blocks make a skip index, a lookup searches the
+// maxima and decodes one block only
+// Elements are appended in increasing order to an unpacked
+// tail block, which is packed when full
+
+#ifndef JNU_COMPRESSED_ARRAY_SET_H
+#define JNU_COMPRESSED_ARRAY_SET_H
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <emmintrin.h>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_search.h"
+
+namespace jnu {
+// Compressed sorted set
+// Template arguments:
+// T - element type, 32 or 64 bit unsigned integer
+template<typename T>
+class CompressedArraySet {
+  static_assert(std::is_unsigned<T>::value &&
+                (sizeof(T) == 4 || sizeof(T) == 8),
+                "Elements must be 32 or 64 bit unsigned integers");
+  const static size_t LANES = 4;  // Lanes of block
+  const static size_t WB = sizeof(T) * 8;  // Bits of word
+  // Packed block header
+  struct Block {
+    T m_base;  // First element
+    size_t m_off;  // Offset of words
+    size_t m_exc;  // Offset of exceptions
+    uint8_t m_bits;  // Bits of packed deltas
+    uint8_t m_n_exc;  // Number of exceptions
+  };
+  typedef DArray<T, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> WordArr;
+  typedef DArray<Block, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> BlockArr;
+  typedef DArray<uint8_t, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> PosArr;
+public:
+  static constexpr size_t BLOCK = 128;  // Elements of block
+  typedef T Type;  // Element type
+  typedef T Key;  // Key type
+  // Forward iterator, keeps a decoded block
+  class Iterator {
+    friend class CompressedArraySet;
+  public:
+    // Get element
+    T operator*() const {
+      return m_buf[m_pos];
+    }
+    // Check if valid
+    operator bool() const {
+      return m_pos < m_n;
+    }
+    // Move to next element
+    Iterator& operator++() {
+      if (++m_pos >= m_n && m_blk < m_set->m_blocks.Size()) {
+        Load(m_blk + 1);
+      }
+      return *this;
+    }
+  private:
+    // Constructor, at first element of block
+    Iterator(const CompressedArraySet* set, size_t blk)
+      : m_set (set) {
+      Load(blk);
+    }
+    // Decode block, the tail if blk is the number of blocks
+    void Load(size_t blk) {
+      m_blk = blk;
+      m_pos = 0;
+      m_n = m_set->Decode(blk, m_buf);
+    }
+    const CompressedArraySet* m_set;  // Iterated set
+    size_t m_blk;  // Current block
+    size_t m_pos;  // Position in block
+    size_t m_n;  // Elements of block
+    alignas(16) T m_buf[BLOCK];  // Decoded block
+  };
+  // Constructor
+  // Input: mm - memory manager (use buildin as default)
+  CompressedArraySet(memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_words (0, mm),
+      m_blocks (0, mm),
+      m_max (0, mm),
+      m_exc (0, mm),
+      m_exc_pos (0, mm),
+      m_sz (0),
+      m_tail_sz (0) {
+  }
+  // Keep unique, no copy constructor allowed
+  CompressedArraySet(const CompressedArraySet& s) = delete;
+  // Keep unique, no assign operator allowed
+  CompressedArraySet& operator=(const CompressedArraySet& s) = delete;
+  // Get set size
+  size_t Size() const {
+    return m_sz;
+  }
+  // Check if set is empty
+  bool IsEmpty() const {
+    return m_sz <= 0;
+  }
+  // Number of packed blocks
+  size_t Blocks() const {
+    return m_blocks.Size();
+  }
+  // Memory used by elements, in bytes
+  size_t Bytes() const {
+    return m_words.Size() * sizeof(T) +
+           m_blocks.Size() * (sizeof(Block) + sizeof(T)) +
+           m_exc.Size() * (sizeof(T) + 1) + sizeof(*this);
+  }
+  // Clear set only
+  void Clear() {
+    m_words.Clear();
+    m_blocks.Clear();
+    m_max.Clear();
+    m_exc.Clear();
+    m_exc_pos.Clear();
+    m_sz = 0;
+    m_tail_sz = 0;
+  }
+  // Clear set and free memory
+  void Free() {
+    Clear();
+    m_words.Free();
+    m_blocks.Free();
+    m_max.Free();
+    m_exc.Free();
+    m_exc_pos.Free();
+  }
+  // Append element, must be greater than all elements
+  // Return: true - success
+  //         false - element out of order, or fail to allocate
+  //         memory
+  bool Append(const T& t) {
+    if (m_sz && !(Back() < t)) {
+      return false;
+    }
+    if (m_tail_sz >= BLOCK && !Pack()) {
+      return false;
+    }
+    m_tail[m_tail_sz++] = t;
+    ++m_sz;
+    return true;
+  }
+  // Append sorted array of unique elements
+  // Return: true - success
+  //         false - elements out of order (elements before are
+  //         appended), or fail to allocate memory
+  bool Append(const T* t, size_t t_sz) {
+    for (size_t i = 0; i < t_sz; ++i) {
+      if (!Append(t[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Replace elements by sorted array of unique elements
+  bool Assign(const T* t, size_t t_sz) {
+    Clear();
+    return Append(t, t_sz);
+  }
+  // Get greatest element, set must not be empty
+  T Back() const {
+    return m_tail_sz ? m_tail[m_tail_sz - 1] : *m_max.RBegin();
+  }
+  // Check if key is in set
+  bool Find(const T& key) const {
+    if (!m_sz) {
+      return false;
+    }
+    size_t blk = Which(key);  // Block may contain key
+    if (blk >= m_blocks.Size()) {  // In tail
+      const T* e = m_tail + m_tail_sz;  // End of tail
+      const T* p = search::LowerBound<const T>(m_tail, e, key);
+      return p < e && *p == key;
+    }
+    if (key < m_blocks[blk].m_base) {  // Between blocks
+      return false;
+    }
+    if (key == m_max[blk]) {
+      return true;
+    }
+    alignas(16) T buf[BLOCK];  // Decoded block
+    Decode(blk, buf);
+    return *search::LowerBound(buf, buf + BLOCK, key) == key;
+  }
+  // Iterator at first element
+  Iterator Begin() const {
+    return Iterator(this, 0);
+  }
+  // Iterator at first element not less than key
+  Iterator LowerBound(const T& key) const {
+    Iterator i(this, Which(key));
+    i.m_pos = search::LowerBound(i.m_buf, i.m_buf + i.m_n, key) -
+              i.m_buf;  // Within block, its maximum is not less
+    return i;
+  }
+  // Iterate elements in order, a block is decoded at a time
+  // Input: f - function called as f(T)
+  template<typename F>
+  void ForEach(F f) const {
+    alignas(16) T buf[BLOCK];  // Decoded block
+    for (size_t i = 0; i <= m_blocks.Size(); ++i) {
+      size_t n = Decode(i, buf);
+      for (size_t j = 0; j < n; ++j) {
+        f(buf[j]);
+      }
+    }
+  }
+private:
+  // Words of lane packed by bits
+  static size_t LaneWords(size_t bits) {
+    return (bits * (BLOCK / LANES) + WB - 1) / WB;
+  }
+  // Bits needed by value
+  static size_t Width(T v) {
+    return v ? WB - (sizeof(T) == 4 ? __builtin_clz(v) :
+                                     __builtin_clzll(v)) : 0;
+  }
+  // Mask of low bits
+  static T Mask(size_t bits) {
+    return bits >= WB ? (T) -1 : ((T) 1 << bits) - 1;
+  }
+  // Block may contain key, first block whose maximum is not
+  // less than key, or the tail
+  size_t Which(const T& key) const {
+    return search::LowerBound(m_max.Begin(), m_max.End(), key) -
+           m_max.Begin();
+  }
+  // Append n elements to array, memory grows by power of 2
+  template<typename H>
+  static bool Grow(H& a, size_t n) {
+    if (!n) {
+      return true;
+    }
+    size_t c = 1;  // New capacity
+    while (c < a.Size() + n) {
+      c <<= 1;
+    }
+    return a.Reserve(c) && a.Expand(a.End(), n);
+  }
+  // Delete elements of array from position sz
+  template<typename H>
+  static void Truncate(H& a, size_t sz) {
+    a.Delete(a.Begin() + sz, a.Size() - sz);
+  }
+  // Pack full tail into a new block
+  bool Pack() {
+    T d[BLOCK];  // D4 deltas
+    size_t cnt[WB + 1] = {0};  // Number of deltas of each width
+    for (size_t i = 0; i < BLOCK; ++i) {
+      d[i] = m_tail[i] - m_tail[i < LANES ? 0 : i - LANES];
+      ++cnt[Width(d[i])];
+    }
+    // Width of smallest size, exceptions cost a word and a byte
+    size_t bits = WB;  // Width of packed deltas
+    size_t best = LaneWords(WB) * LANES * sizeof(T);  // Size of width
+    size_t n_exc = 0;  // Deltas wider than width
+    for (size_t b = WB; b-- > 0;) {
+      n_exc += cnt[b + 1];
+      size_t sz = LaneWords(b) * LANES * sizeof(T) +
+                  n_exc * (sizeof(T) + 1);
+      if (sz < best) {
+        best = sz;
+        bits = b;
+      }
+    }
+    n_exc = 0;
+    for (size_t b = bits + 1; b <= WB; ++b) {
+      n_exc += cnt[b];
+    }
+    Block h = {m_tail[0], m_words.Size(), m_exc.Size(),
+               (uint8_t) bits, (uint8_t) n_exc};
+    size_t n_words = LaneWords(bits) * LANES;  // Words of block
+    if (!Grow(m_words, n_words) || !Grow(m_exc, n_exc) ||
+        !Grow(m_exc_pos, n_exc) || !Grow(m_blocks, 1) ||
+        !Grow(m_max, 1)) {  // Roll back
+      Truncate(m_words, h.m_off);
+      Truncate(m_exc, h.m_exc);
+      Truncate(m_exc_pos, h.m_exc);
+      Truncate(m_blocks, m_max.Size());
+      return false;
+    }
+    *m_blocks.RBegin() = h;
+    *m_max.RBegin() = m_tail[BLOCK - 1];
+    T* w = m_words.Begin() + h.m_off;  // Words of block
+    T* e = m_exc.Begin() + h.m_exc;  // Exceptions of block
+    uint8_t* ep = m_exc_pos.Begin() + h.m_exc;  // Their positions
+    T mask = Mask(bits);
+    for (size_t i = 0; i < BLOCK; ++i) {
+      if (d[i] > mask) {
+        *e++ = d[i] >> bits;
+        *ep++ = (uint8_t) i;
+      }
+      d[i] &= mask;
+    }
+    memset(w, 0, n_words * sizeof(T));
+    for (size_t l = 0; l < LANES && bits; ++l) {
+      for (size_t j = 0, bit = 0; j < BLOCK / LANES; ++j, bit += bits) {
+        T v = d[j * LANES + l];
+        size_t k = bit / WB;  // Word of lane
+        size_t s = bit % WB;  // Shift in word
+        w[k * LANES + l] |= v << s;
+        if (s + bits > WB) {
+          w[(k + 1) * LANES + l] |= v >> (WB - s);
+        }
+      }
+    }
+    m_tail_sz = 0;
+    return true;
+  }
+  // Unpack deltas of block
+  // 32 bit lanes are unpacked 4 a time (SSE2)
+  static void Unpack(const T* w, size_t bits, T* out) {
+    T mask = Mask(bits);
+    if constexpr (sizeof(T) == 4) {
+      const __m128i* in = (const __m128i*) w;
+      __m128i m = _mm_set1_epi32((int) mask);
+      __m128i cur = _mm_load_si128(in);  // Current words of lanes
+      size_t s = 0;  // Shift in words
+      for (size_t j = 0; j < BLOCK / LANES; ++j) {
+        __m128i v = _mm_srl_epi32(cur, _mm_cvtsi32_si128((int) s));
+        s += bits;
+        if (s > WB) {  // Crosses words
+          cur = _mm_load_si128(++in);
+          v = _mm_or_si128(v, _mm_sll_epi32(cur,
+                                _mm_cvtsi32_si128((int) (WB + bits - s))));
+          s -= WB;
+        } else if (s == WB && j + 1 < BLOCK / LANES) {  // Ends words
+          cur = _mm_load_si128(++in);
+          s = 0;
+        }
+        _mm_store_si128((__m128i*) (out + j * LANES), _mm_and_si128(v, m));
+      }
+    } else {
+      for (size_t l = 0; l < LANES; ++l) {
+        for (size_t j = 0, bit = 0; j < BLOCK / LANES; ++j, bit += bits) {
+          size_t k = bit / WB;  // Word of lane
+          size_t s = bit % WB;  // Shift in word
+          T v = w[k * LANES + l] >> s;
+          if (s + bits > WB) {
+            v |= w[(k + 1) * LANES + l] << (WB - s);
+          }
+          out[j * LANES + l] = v & mask;
+        }
+      }
+    }
+  }
+  // Decode block, the tail if blk is the number of blocks
+  // Return: number of elements
+  size_t Decode(size_t blk, T* out) const {
+    if (blk >= m_blocks.Size()) {
+      memcpy(out, m_tail, m_tail_sz * sizeof(T));
+      return m_tail_sz;
+    }
+    const Block& h = m_blocks[blk];
+    if (h.m_bits) {
+      Unpack(m_words.Begin() + h.m_off, h.m_bits, out);
+    } else {
+      memset(out, 0, BLOCK * sizeof(T));
+    }
+    for (size_t i = h.m_exc; i < h.m_exc + h.m_n_exc; ++i) {  // Patch
+      out[m_exc_pos[i]] |= m_exc[i] << h.m_bits;
+    }
+    if constexpr (sizeof(T) == 4) {  // Prefix sum of lanes (SSE2)
+      __m128i v = _mm_set1_epi32((int) h.m_base);
+      for (size_t i = 0; i < BLOCK; i += LANES) {
+        __m128i* p = (__m128i*) (out + i);
+        v = _mm_add_epi32(v, _mm_load_si128(p));
+        _mm_store_si128(p, v);
+      }
+    } else {  // Prefix sum of lanes
+      for (size_t i = 0; i < LANES; ++i) {
+        out[i] += h.m_base;
+      }
+      for (size_t i = LANES; i < BLOCK; ++i) {
+        out[i] += out[i - LANES];
+      }
+    }
+    return BLOCK;
+  }
+  WordArr m_words;  // Packed words of blocks
+  BlockArr m_blocks;  // Headers of blocks
+  WordArr m_max;  // Maxima of blocks (skip index)
+  WordArr m_exc;  // High bits of exceptions
+  PosArr m_exc_pos;  // Positions of exceptions
+  size_t m_sz;  // Number of elements
+  size_t m_tail_sz;  // Elements of tail
+  alignas(16) T m_tail[BLOCK];  // Unpacked tail
+};
+}
+
+#endif
@@ -20,4 +20,8 @@
 // Get size of pointer
 #define JNU_PTR_SZ sizeof(void*)
 
+// Size of cache line, used for padding shared data
+// to avoid false sharing
+#define JNU_CACHE_LINE_SZ 64
+
 #endif
@@ -0,0 +1,169 @@
+// By JNI
+// Read optimized search index of sorted set
+// Keys of the set are copied in Eytzinger (BFS) order, node i
+// has children 2i and 2i + 1, so the top of the tree shares
+// a few cache lines and the nodes of next levels can be
+// prefetched while the current level is compared
+// Search is branchless, the rank of each node maps the
+// result back to the position in set
+// The index is a companion of the set (SetIndex), it is
+// rebuilt (fully or incrementally) after writes
+
+#ifndef JNU_EYTZINGER_H
+#define JNU_EYTZINGER_H
+
+#include <utility>
+#include <type_traits>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_array_set.h"
+#include "jnu_set_index.h"
+
+namespace jnu {
+// Eytzinger layout index of sorted set
+// Template arguments:
+// S - sorted set type (ArraySetT)
+template<typename S>
+class EytzingerIndex : public SetIndex<S> {
+  typedef SetIndex<S> Base;  // Companion index base
+  typedef typename S::Type T;  // Element type
+  typedef typename S::Key K;  // Key type
+  typedef typename S::Res Res;  // Search result
+  using Base::m_set;
+  // Plain keys are copied as memory
+  typedef typename std::conditional<std::is_trivially_copyable<K>::value,
+                                    ARR_MEM_ALLOC,
+                                    ARR_OBJ_ALLOC>::type KA;
+  // Keys in Eytzinger order (1 based), cache line aligned
+  typedef DArray<K, KA, 1, JNU_CACHE_LINE_SZ> Keys;
+  // Rank (set position) of each node
+  typedef DArray<size_t, ARR_MEM_ALLOC, 1> Ranks;
+  // Nodes 4 levels down share the prefetched cache line
+  const static size_t STRIDE = JNU_MAX(JNU_CACHE_LINE_SZ / sizeof(K), 2);
+public:
+  // Constructor, index is empty until rebuilt
+  // Input: set - the indexed set
+  //        mm - memory manager of index
+  EytzingerIndex(const S& set, memory::MMBase* mm = &memory::MM_BUILDIN)
+    : Base (set),
+      m_keys (0, mm),
+      m_ranks (0, mm),
+      m_b_keys (0, mm),
+      m_b_ranks (0, mm),
+      m_b_sz (0),
+      m_b_node (0),
+      m_b_rank (0) {
+  }
+  // Deconstructor
+  ~EytzingerIndex() {
+  }
+  // Keep unique, no copy constructor allowed
+  EytzingerIndex(const EytzingerIndex& i) = delete;
+  // Keep unique, no assign operator allowed
+  EytzingerIndex& operator=(const EytzingerIndex& i) = delete;
+  // Rebuild index completely
+  // Return: true - success, false - fail to allocate memory
+  bool Rebuild() {
+    m_b_node = 0;  // Restart pending rebuild
+    return Rebuild(m_set.Size() + 1);
+  }
+  // Rebuild index incrementally
+  // A rebuild is started if none is pending, it is restarted
+  // if set size changed since it started, the index in use
+  // is replaced only when rebuild completes
+  // Input: step - maximum number of elements to copy
+  // Return: true - rebuild completed, false - rebuild is
+  //         pending or fail to allocate memory
+  bool Rebuild(size_t step) {
+    size_t n = m_set.Size();  // Number of elements
+    if (!m_b_node || m_b_sz != n) {  // Start rebuild
+      m_b_keys.Clear();
+      m_b_ranks.Clear();
+      if (!m_b_keys.Expand(m_b_keys.Begin(), n + 1) ||
+          !m_b_ranks.Expand(m_b_ranks.Begin(), n + 1)) {
+        return false;
+      }
+      m_b_sz = n;
+      m_b_rank = 0;
+      m_b_node = First(1, n);  // In-order first node
+    }
+    const T* d = m_set.Begin();  // Sorted elements
+    // In-order walk of the implicit tree visits ranks in order
+    for (; m_b_node && step; --step) {
+      m_b_keys[m_b_node] = S::KeyOf(d[m_b_rank]);
+      m_b_ranks[m_b_node] = m_b_rank++;
+      m_b_node = Next(m_b_node, n);
+    }
+    if (m_b_node) {
+      return false;  // Pending
+    }
+    m_keys = std::move(m_b_keys);  // Replace index in use
+    m_ranks = std::move(m_b_ranks);
+    Base::Built();
+    return true;
+  }
+  // Check if a rebuild is pending
+  bool IsBuilding() const {
+    return m_b_node != 0;
+  }
+  // Locate key
+  // Return: the location of key,
+  //         if not found, the location the key should
+  //         be inserted
+  Res Locate(const K& key) const {
+    size_t n = m_set.Size();  // Number of elements
+    size_t p = Base::NPOS;  // Lower bound of key
+    if (Base::IsUsable()) {
+      const K* k = m_keys.Begin();  // Eytzinger keys
+      size_t i = 1;  // Current node
+      while (i <= n) {  // Branchless descend
+        __builtin_prefetch(k + STRIDE * i);
+        i = 2 * i + S::KeyLess(k[i], key);
+      }
+      // Cancel the right turns made after last left turn,
+      // node of last left turn is the first key not less
+      i >>= __builtin_ffsll(~(long long) i);
+      p = i ? m_ranks[i] : n;  // Position in set
+    }
+    return Base::Validate(key, p);
+  }
+  // Find key
+  // Return: the location if found
+  //         invalid location if not found
+  T* Find(const K& key) const {
+    Res r = Locate(key);
+    return r.Found() ? *r : NULL;
+  }
+private:
+  // In-order first node of sub tree
+  static size_t First(size_t i, size_t n) {
+    if (i > n) {
+      return 0;  // Empty tree
+    }
+    while (2 * i <= n) {  // Left most
+      i = 2 * i;
+    }
+    return i;
+  }
+  // In-order next node, 0 if finished
+  static size_t Next(size_t i, size_t n) {
+    if (2 * i + 1 <= n) {  // Left most of right sub tree
+      return First(2 * i + 1, n);
+    }
+    while (i & 1) {  // Up while coming from right child
+      i >>= 1;
+    }
+    return i >> 1;  // Parent of left child
+  }
+  Keys m_keys;  // Keys in use
+  Ranks m_ranks;  // Ranks in use
+  Keys m_b_keys;  // Keys being built
+  Ranks m_b_ranks;  // Ranks being built
+  size_t m_b_sz;  // Set size of rebuild
+  size_t m_b_node;  // Next node of rebuild, 0 if none pending
+  size_t m_b_rank;  // Next rank of rebuild
+};
+}
+
+#endif
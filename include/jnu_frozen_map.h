@@ -0,0 +1,264 @@
+// By JNI
+// Perfect hash index of sorted set
+// For sets built once and only read afterward, freezing maps
+// every key to a slot of its own by a perfect hash (pilots of
+// buckets as PTHash), the slot stores the position of the key
+// in the set, a lookup reads the pilot of its bucket, the set
+// position of its slot, then the element to check the key,
+// elements stay in the sorted set, so ordered iteration and
+// ranges still work
+// Keys are hashed into buckets (skewed, 60% of keys into 30%
+// of buckets), buckets are placed largest first by searching
+// a pilot mixed into the hash of their keys until all keys
+// fall into free slots
+// The hash is not minimal, the table has n + n / 16 slots of
+// 4 byte set positions (about 4.25 bytes per key) to speed up
+// the search, plus 2 byte pilots of 5 n / log2(n) buckets
+// (0.5 byte per key for a million keys), free slots point to
+// the first element (checked as any other slot)
+// The index is a companion of the set (SetIndex), found
+// elements are checked to have the key, a stale index falls
+// back to the search of the set
+
+#ifndef JNU_FROZEN_MAP_H
+#define JNU_FROZEN_MAP_H
+
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_array_set.h"
+#include "jnu_set_index.h"
+
+namespace jnu {
+// Frozen index of sorted set
+// Template arguments:
+// S - sorted set type (ArraySetT)
+// H - hash function of key, equal keys must have equal hashes
+template<typename S, typename H = std::hash<typename S::Key>>
+class FrozenMap : public SetIndex<S> {
+  typedef SetIndex<S> Base;  // Companion index base
+  typedef typename S::Type T;  // Element type
+  typedef typename S::Key K;  // Key type
+  using Base::m_set;
+  typedef DArray<uint16_t, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Pilots;
+  typedef DArray<uint32_t, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Slots;
+  typedef DArray<uint64_t, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Words;
+  const static size_t MAX_PILOT = 65536;  // Pilots per bucket
+  const static size_t MAX_SEEDS = 16;  // Tries of hash seeds
+public:
+  // Constructor, index is empty until frozen
+  // Input: set - the indexed set
+  //        mm - memory manager of index
+  FrozenMap(const S& set, memory::MMBase* mm = &memory::MM_BUILDIN)
+    : Base (set),
+      m_pilots (0, mm),
+      m_index (0, mm),
+      m_mm (mm),
+      m_seed (0),
+      m_buckets (0),
+      m_table (0) {
+  }
+  // Keep unique, no copy constructor allowed
+  FrozenMap(const FrozenMap& f) = delete;
+  // Keep unique, no assign operator allowed
+  FrozenMap& operator=(const FrozenMap& f) = delete;
+  // Build perfect hash of set keys
+  // Return: true - success
+  //         false - fail to allocate memory, or keys with
+  //         equal hashes
+  bool Freeze() {
+    m_pilots.Clear();
+    m_index.Clear();
+    Base::Unbuilt();  // Unusable until completed
+    size_t n = m_set.Size();  // Number of keys
+    m_table = n + n / 16;  // Table load is about 94%
+    m_buckets = JNU_MIN(n, 5 * n / (64 - __builtin_clzll(n | 1)) + 1);
+    if (!n) {
+      Base::Built();
+      return true;
+    }
+    Words hs (0, m_mm);  // Hashes of keys
+    Words grouped (0, m_mm);  // Hashes grouped by bucket
+    Slots start (0, m_mm);  // First hash of buckets
+    Slots order (0, m_mm);  // Buckets by size, largest first
+    Words taken (0, m_mm);  // Taken slots
+    if (m_table > UINT32_MAX ||
+        !Resize(hs, n) || !Resize(grouped, n) ||
+        !Resize(start, m_buckets + 1) || !Resize(order, m_buckets) ||
+        !Resize(taken, (m_table + 63) / 64) ||
+        !Resize(m_pilots, m_buckets) || !Resize(m_index, m_table)) {
+      return false;
+    }
+    for (size_t s = 0; s < MAX_SEEDS; ++s) {
+      m_seed = Mix(s + 1);
+      if (Place(hs, grouped, start, order, taken)) {
+        Index(hs);
+        Base::Built();
+        return true;
+      }
+    }
+    return false;
+  }
+  // Number of buckets
+  size_t Buckets() const {
+    return m_buckets;
+  }
+  // Find key
+  // Two loads of index (pilot and slot), then the element is
+  // loaded to check the key
+  // Return: the location if found
+  //         invalid location if not found
+  T* Find(const K& key) const {
+    if (!Base::IsUsable()) {
+      return m_set.Find(key);
+    }
+    uint64_t h = Hash(key);
+    T* p = m_set.Begin() + m_index[Position(h, m_pilots[Bucket(h)])];
+    return S::KeyLess(S::KeyOf(*p), key) ||
+           S::KeyLess(key, S::KeyOf(*p)) ? NULL : p;
+  }
+private:
+  // 64 bit finalizer
+  static uint64_t Mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+  // Hash of key, with seed
+  uint64_t Hash(const K& key) const {
+    return Mix(H()(key) ^ m_seed);
+  }
+  // Bucket of hash, 60% of hashes go to first 30% of buckets
+  size_t Bucket(uint64_t h) const {
+    uint64_t x = h >> 32;  // High bits choose bucket
+    size_t b = m_buckets * 3 / 10;  // Dense buckets
+    if ((h & 0xffffffff) < 0x99999999ULL) {  // 60%
+      return (size_t) ((x * b) >> 32);
+    }
+    return b + (size_t) ((x * (m_buckets - b)) >> 32);
+  }
+  // Slot of hash by pilot
+  size_t Position(uint64_t h, size_t pilot) const {
+    return (size_t) (((Mix(h ^ (pilot * 0x9e3779b97f4a7c15ULL)) >> 32) *
+                      m_table) >> 32);
+  }
+  // Clear array and resize it to n elements
+  template<typename A>
+  static bool Resize(A& a, size_t n) {
+    a.Clear();
+    return !n || a.Expand(a.Begin(), n);
+  }
+  // Check if slot q is taken
+  static bool Taken(const Words& taken, size_t q) {
+    return (taken[q / 64] >> (q % 64)) & 1;
+  }
+  // Flip taken flag of slot q
+  static void Flip(Words& taken, size_t q) {
+    taken[q / 64] ^= 1ULL << (q % 64);
+  }
+  // Find pilots of all buckets with current seed
+  // Return: false - keys with equal hashes, or pilots exhausted
+  bool Place(Words& hs, Words& grouped, Slots& start, Slots& order,
+             Words& taken) {
+    size_t n = m_set.Size();  // Number of keys
+    const T* d = m_set.Begin();  // Sorted keys
+    memset(start.Begin(), 0, start.Size() * sizeof(uint32_t));
+    memset(taken.Begin(), 0, taken.Size() * sizeof(uint64_t));
+    for (size_t i = 0; i < n; ++i) {  // Count keys of buckets
+      hs[i] = Hash(S::KeyOf(d[i]));
+      ++start[Bucket(hs[i]) + 1];
+    }
+    size_t max_sz = 0;  // Size of largest bucket
+    for (size_t b = 0; b < m_buckets; ++b) {
+      max_sz = JNU_MAX(max_sz, (size_t) start[b + 1]);
+      start[b + 1] += start[b];
+    }
+    // Group by bucket, order is used as fill counts first
+    memset(order.Begin(), 0, order.Size() * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+      size_t b = Bucket(hs[i]);
+      grouped[start[b] + order[b]++] = hs[i];
+    }
+    for (size_t b = 0; b < m_buckets; ++b) {  // Reject equal hashes
+      uint64_t* g = grouped.Begin() + start[b];
+      size_t c = start[b + 1] - start[b];
+      for (size_t i = 1; i < c; ++i) {  // Insertion sort, small
+        uint64_t v = g[i];
+        size_t j = i;
+        for (; j > 0 && g[j - 1] > v; --j) {
+          g[j] = g[j - 1];
+        }
+        g[j] = v;
+        if (j > 0 && g[j - 1] == v) {
+          return false;
+        }
+      }
+    }
+    // Buckets by size, largest first (counting sort)
+    Slots cnt (0, m_mm);  // Buckets of each size
+    if (!Resize(cnt, max_sz + 2)) {
+      return false;
+    }
+    memset(cnt.Begin(), 0, cnt.Size() * sizeof(uint32_t));
+    for (size_t b = 0; b < m_buckets; ++b) {
+      ++cnt[max_sz - (start[b + 1] - start[b]) + 1];
+    }
+    for (size_t s = 1; s < cnt.Size(); ++s) {
+      cnt[s] += cnt[s - 1];
+    }
+    for (size_t b = 0; b < m_buckets; ++b) {
+      order[cnt[max_sz - (start[b + 1] - start[b])]++] = b;
+    }
+    for (size_t i = 0; i < m_buckets; ++i) {  // Search pilots
+      size_t b = order[i];
+      const uint64_t* g = grouped.Begin() + start[b];
+      size_t c = start[b + 1] - start[b];
+      size_t p = 0;  // Pilot
+      for (;; ++p) {
+        if (p >= MAX_PILOT) {
+          return false;
+        }
+        size_t j = 0;  // Keys placed
+        for (; j < c; ++j) {
+          size_t q = Position(g[j], p);
+          if (Taken(taken, q)) {
+            break;
+          }
+          Flip(taken, q);
+        }
+        if (j == c) {
+          break;
+        }
+        while (j-- > 0) {  // Undo placed keys
+          Flip(taken, Position(g[j], p));
+        }
+      }
+      m_pilots[b] = (uint16_t) p;
+    }
+    return true;
+  }
+  // Store set positions of keys in their slots, free slots
+  // point to the first element for missing keys
+  void Index(const Words& hs) {
+    size_t n = m_set.Size();  // Number of keys
+    memset(m_index.Begin(), 0, m_table * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+      m_index[Position(hs[i], m_pilots[Bucket(hs[i])])] = (uint32_t) i;
+    }
+  }
+  Pilots m_pilots;  // Pilots of buckets
+  Slots m_index;  // Set positions of slots
+  memory::MMBase* m_mm;  // Memory manager
+  uint64_t m_seed;  // Hash seed
+  size_t m_buckets;  // Number of buckets
+  size_t m_table;  // Number of slots
+};
+}
+
+#endif
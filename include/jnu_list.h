@@ -24,6 +24,7 @@ public:
   typedef C Type;  // Type of target object
   // Default constructor
   ListBase() {
+    Clear();  // Initialize as empty list
   }
   // Deconstructor
   ~ListBase() {
@@ -484,6 +485,10 @@ private:
   C* m_head;  // List head
   C* m_tail;  // List tail
 };
+template<typename C> class SLink;
+// Concurrent containers built on single link nodes
+template<typename C, typename SLink<C>::Node& (C::*F)()> class AtomicStack;
+template<typename C, typename SLink<C>::Node& (C::*F)()> class MpscQueue;
 // Single link list, built on base of ListBase
 // Template parameter: C - object class type
 template<typename C>
@@ -495,6 +500,11 @@ public:
   class Node {
     // ListBase need access some of its private members
     template<C, typename Node, Node& (C::*F)()> friend class jnu::ListBase;
+    // Concurrent containers access the link directly
+    template<typename T, typename SLink<T>::Node& (T::*F)()>
+    friend class jnu::AtomicStack;
+    template<typename T, typename SLink<T>::Node& (T::*F)()>
+    friend class jnu::MpscQueue;
   public:
     // Default constructor
     Node()
@@ -0,0 +1,651 @@
+// By JNI
+// Log-structured sorted set
+// Writes go to a small sorted buffer (hybrid array with static
+// storage), a full buffer is merged into level 0, and a level
+// exceeding its capacity is merged into the next level, level
+// capacities grow geometrically, so each element is moved
+// O(RATIO) times per level instead of O(n) times per insert
+// A key is kept in one place only (writes of existing keys
+// update them in place), lookups check the buffer and then
+// levels newest first, skipping levels rejected by the filter
+// of the level (no filter by default, BloomFilter of jnu_bloom.h
+// fits as a filter)
+// The interface is the one of ArraySetT, so a set type may be
+// switched by a typedef, hints are accepted and ignored
+// Ordered access (Begin, End, Data, operator[], Locate and
+// bound and range searches) is a merged view, the set is
+// compacted into one sorted run first, Find is not
+// Since ordered access compacts the set, const readers modify
+// it, the set is not safe for concurrent access of readers
+// Bulk insertion, cursor and batch searches are not provided
+
+#ifndef JNU_LSM_ARRAY_SET_H
+#define JNU_LSM_ARRAY_SET_H
+
+#include <utility>
+#include <type_traits>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_array_set.h"
+
+namespace jnu {
+// Default level filter, accepts all keys
+// A filter is reset to the size of its level after merges,
+// then all keys of the level are added
+template<typename K>
+class LsmNoFilter {
+public:
+  // Constructor
+  LsmNoFilter(memory::MMBase* mm) {
+  }
+  // Clear filter for n keys
+  bool Reset(size_t n) {
+    return true;
+  }
+  // Add key
+  void Add(const K& key) {
+  }
+  // Check if key may be in level
+  bool MayContain(const K& key) const {
+    return true;
+  }
+};
+// Log-structured sorted set
+// Template arguments:
+// C - the array data type of levels
+// K - the type of key
+// KEY - the function for getting key from underline objects
+// LESS - comparison of key (less than)
+// BUF - size of write buffer
+// F - filter type of levels
+template<typename C, typename K,
+         auto KEY = (const K& (*)(const typename C::Type)) NULL,
+         auto LESS = (bool (*) (const K&, const K&)) NULL,
+         size_t BUF = 64, typename F = LsmNoFilter<K>>
+class LsmArraySetT {
+  typedef ArraySetT<C, K, KEY, LESS> Set;  // Level set
+  typedef typename Set::Type T;  // Underline data type
+  // Buffer set, static storage only
+  typedef ArraySetT<HArray<T, BUF, typename Set::Alloc, 1>,
+                    K, KEY, LESS> Buf;
+  const static size_t RATIO = 4;  // Capacity ratio of levels
+  const static size_t MAX_LEVELS = 30;  // Maximum levels
+  static_assert(BUF > 0, "Buffer size must be positive");
+public:
+  typedef T Type;  // Underline data type
+  typedef K Key;  // Key type
+  typedef F Filter;  // Level filter type
+  typedef typename Set::View View;  // View of merged run
+  // Insertion result structure
+  class Res {
+    friend class LsmArraySetT;
+  public:
+    // Get element, valid until next modification
+    T* operator*() const {
+      return m_it;
+    }
+    // Check if valid
+    operator bool() const {
+      return m_it != NULL;
+    }
+    // Check if data inserted
+    bool Inserted() const {
+      return !m_found;
+    }
+    // Check if data found
+    bool Found() const {
+      return m_found;
+    }
+  private:
+    // Constructor
+    Res(T* it = NULL, bool found = false)
+      : m_it (it),
+        m_found (found) {
+    }
+    T* m_it;  // Element
+    bool m_found;  // Flag for data found
+  };
+  // Constructor
+  // Input: rsv_sz - reserved size
+  //        mm - memory manager (use buildin as default)
+  LsmArraySetT(size_t rsv_sz = 0,
+               memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_buf (0, mm),
+      m_levels (mm),
+      m_depth (0),
+      m_size (0) {
+    m_levels.NewArr(8, MAX_LEVELS, mm);
+    Reserve(rsv_sz);
+  }
+  // Keep unique, no copy constructor allowed
+  LsmArraySetT(const LsmArraySetT& s) = delete;
+  // Keep unique, no assign operator allowed
+  LsmArraySetT& operator=(const LsmArraySetT& s) = delete;
+  // Reserve space of rsv_sz elements in the level they
+  // settle in
+  bool Reserve(size_t rsv_sz) {
+    if (!m_levels) {
+      return false;
+    }
+    size_t i = 0;  // Level of rsv_sz elements
+    while (i + 1 < MAX_LEVELS && Capacity(i) < rsv_sz) {
+      ++i;
+    }
+    return Level(i).m_set.Reserve(rsv_sz);
+  }
+  // Get set size
+  size_t Size() const {
+    return m_size;
+  }
+  // Check if set is empty
+  bool IsEmpty() const {
+    return m_size <= 0;
+  }
+  // Number of levels in use
+  size_t Levels() const {
+    return m_depth;
+  }
+  // Clear set only
+  void Clear() {
+    m_buf.Clear();
+    for (size_t i = 0; i < m_depth; ++i) {
+      Level(i).m_set.Clear();
+      Level(i).m_filter.Reset(0);
+    }
+    m_depth = 0;
+    m_size = 0;
+  }
+  // Clear set and free memory
+  void Free() {
+    Clear();
+    for (size_t i = 0; i < m_levels.Size(); ++i) {
+      Level(i).m_set.Free();
+    }
+  }
+  // Recycle unused memory of levels
+  bool Recycle() {
+    bool r = true;  // All levels recycled
+    for (size_t i = 0; i < m_levels.Size(); ++i) {
+      r = Level(i).m_set.Recycle() && r;
+    }
+    return r;
+  }
+  // Get merged run
+  const C& Data() const {
+    return Run().Data();
+  }
+  // Get begin of merged run
+  T* Begin() const {
+    return Run().Begin();
+  }
+  // Get end of merged run (exclude)
+  T* End() const {
+    return Run().End();
+  }
+  // Get reversed begin of merged run
+  T* RBegin() const {
+    return Run().RBegin();
+  }
+  // Get reversed end of merged run (exclude)
+  T* REnd() const {
+    return Run().REnd();
+  }
+  // Get element at position i of merged run
+  T& operator[](size_t i) {
+    return Run().Begin()[i];
+  }
+  // Find key, the buffer and then levels newest first
+  // Filters of levels are checked for search keys of key type
+  // Return: the location if found, valid until next
+  //         modification
+  //         invalid location if not found
+  template<typename Q, typename... Hints>
+  T* Find(const Q& key, Hints...) const {
+    if (T* p = m_buf.Find(key)) {  // Newest first
+      return p;
+    }
+    for (size_t i = 0; i < m_depth; ++i) {
+      const LevelT& l = Level(i);
+      if (MayContain(l, key)) {
+        if (T* p = l.m_set.Find(key)) {
+          return p;
+        }
+      }
+    }
+    return NULL;
+  }
+  // Locate key in merged run
+  // Return: the location of key,
+  //         if not found, the location the key should
+  //         be inserted
+  template<typename Q, typename... Hints>
+  Res Locate(const Q& key, Hints...) const {
+    typename Set::Res r = Run().Locate(key);
+    return Res(*r, r.Found());
+  }
+  // Get the first element not less than key in merged run
+  template<typename Q, typename... Hints>
+  T* LowerBound(const Q& key, Hints...) const {
+    return Run().LowerBound(key);
+  }
+  // Get the first element greater than key in merged run
+  template<typename Q, typename... Hints>
+  T* UpperBound(const Q& key, Hints...) const {
+    return Run().UpperBound(key);
+  }
+  // Get elements equal to key in merged run
+  template<typename Q, typename... Hints>
+  View EqualRange(const Q& key, Hints...) const {
+    return Run().EqualRange(key);
+  }
+  // Get elements of keys in [lo, hi) in merged run
+  template<typename Q, typename R, typename... Hints>
+  View Range(const Q& lo, const R& hi, Hints...) const {
+    return Run().Range(lo, hi);
+  }
+  // Count elements of keys in [lo, hi)
+  template<typename Q, typename R, typename... Hints>
+  size_t CountRange(const Q& lo, const R& hi, Hints...) const {
+    return Run().CountRange(lo, hi);
+  }
+  // No replace insert single element
+  // Return: insert result, including
+  //         the position of insertion and if
+  //         the element already exists
+  template<typename... Hints>
+  Res Insert(const T& t, Hints...) {
+    T* p = Find(Set::KeyOf(t));
+    return p ? Res(p, true) : Add<const T>(t);
+  }
+  // Replace insert single element
+  template<typename... Hints>
+  Res ReplaceInsert(const T& t, Hints...) {
+    T* p = Find(Set::KeyOf(t));
+    if (p) {
+      *p = t;
+      return Res(p, true);
+    }
+    return Add<const T>(t);
+  }
+  // No replace inject (move) single element
+  template<typename... Hints>
+  Res Inject(T& t, Hints...) {
+    T* p = Find(Set::KeyOf(t));
+    return p ? Res(p, true) : Add<T>(t);
+  }
+  // Replace inject single element
+  template<typename... Hints>
+  Res ReplaceInject(T& t, Hints...) {
+    T* p = Find(Set::KeyOf(t));
+    if (p) {
+      *p = std::move(t);
+      return Res(p, true);
+    }
+    return Add<T>(t);
+  }
+  // No replace insert (unsorted) array of data
+  // Return: true - insert successful
+  template<typename... Hints>
+  bool Insert(const T* t, size_t t_sz, Hints...) {
+    return Each(t, t_sz, [this](const T& e) {
+      return (bool) Insert(e);
+    });
+  }
+  // Replace insert (unsorted) array of data
+  template<typename... Hints>
+  bool ReplaceInsert(const T* t, size_t t_sz, Hints...) {
+    return Each(t, t_sz, [this](const T& e) {
+      return (bool) ReplaceInsert(e);
+    });
+  }
+  // No replace insert array [t, t_end)
+  template<typename... Hints>
+  bool Insert(const T* t, const T* t_end, Hints...) {
+    return Insert(t, (size_t) (t_end - t));
+  }
+  // Replace insert array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInsert(const T* t, const T* t_end, Hints...) {
+    return ReplaceInsert(t, (size_t) (t_end - t));
+  }
+  // No replace insert sorted array, writes go through the
+  // buffer, so it is the same as an unsorted array
+  template<typename... Hints>
+  bool InsertSorted(const T* t, size_t t_sz, Hints...) {
+    return Insert(t, t_sz);
+  }
+  // Replace insert sorted array
+  template<typename... Hints>
+  bool ReplaceInsertSorted(const T* t, size_t t_sz, Hints...) {
+    return ReplaceInsert(t, t_sz);
+  }
+  // No replace insert sorted array [t, t_end)
+  template<typename... Hints>
+  bool InsertSorted(const T* t, const T* t_end, Hints...) {
+    return Insert(t, (size_t) (t_end - t));
+  }
+  // Replace insert sorted array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInsertSorted(const T* t, const T* t_end, Hints...) {
+    return ReplaceInsert(t, (size_t) (t_end - t));
+  }
+  // No replace inject (unsorted) array
+  // Elements in array will be moved to set
+  template<typename... Hints>
+  bool Inject(T* t, size_t t_sz, Hints...) {
+    return Each(t, t_sz, [this](T& e) {
+      return (bool) Inject(e);
+    });
+  }
+  // Replace inject (unsorted) array
+  template<typename... Hints>
+  bool ReplaceInject(T* t, size_t t_sz, Hints...) {
+    return Each(t, t_sz, [this](T& e) {
+      return (bool) ReplaceInject(e);
+    });
+  }
+  // No replace inject array [t, t_end)
+  template<typename... Hints>
+  bool Inject(T* t, T* t_end, Hints...) {
+    return Inject(t, (size_t) (t_end - t));
+  }
+  // Replace inject array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInject(T* t, T* t_end, Hints...) {
+    return ReplaceInject(t, (size_t) (t_end - t));
+  }
+  // No replace inject sorted array
+  template<typename... Hints>
+  bool InjectSorted(T* t, size_t t_sz, Hints...) {
+    return Inject(t, t_sz);
+  }
+  // Replace inject sorted array
+  template<typename... Hints>
+  bool ReplaceInjectSorted(T* t, size_t t_sz, Hints...) {
+    return ReplaceInject(t, t_sz);
+  }
+  // No replace inject sorted array [t, t_end)
+  template<typename... Hints>
+  bool InjectSorted(T* t, T* t_end, Hints...) {
+    return Inject(t, (size_t) (t_end - t));
+  }
+  // Replace inject sorted array [t, t_end)
+  template<typename... Hints>
+  bool ReplaceInjectSorted(T* t, T* t_end, Hints...) {
+    return ReplaceInject(t, (size_t) (t_end - t));
+  }
+  // No replace inject array of arr
+  // The input array will be cleared after inject
+  template<typename H, typename... Hints>
+  bool Inject(H& arr, T* t, size_t t_sz, Hints...) {
+    return Cleared(arr, t, t_sz, Inject(t, t_sz));
+  }
+  // Replace inject array of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInject(H& arr, T* t, size_t t_sz, Hints...) {
+    return Cleared(arr, t, t_sz, ReplaceInject(t, t_sz));
+  }
+  // No replace inject array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool Inject(H& arr, T* t, T* t_end, Hints...) {
+    return Inject(arr, t, (size_t) (t_end - t));
+  }
+  // Replace inject array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInject(H& arr, T* t, T* t_end, Hints...) {
+    return ReplaceInject(arr, t, (size_t) (t_end - t));
+  }
+  // No replace inject sorted array of arr
+  template<typename H, typename... Hints>
+  bool InjectSorted(H& arr, T* t, size_t t_sz, Hints...) {
+    return Inject(arr, t, t_sz);
+  }
+  // Replace inject sorted array of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInjectSorted(H& arr, T* t, size_t t_sz, Hints...) {
+    return ReplaceInject(arr, t, t_sz);
+  }
+  // No replace inject sorted array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool InjectSorted(H& arr, T* t, T* t_end, Hints...) {
+    return Inject(arr, t, (size_t) (t_end - t));
+  }
+  // Replace inject sorted array [t, t_end) of arr
+  template<typename H, typename... Hints>
+  bool ReplaceInjectSorted(H& arr, T* t, T* t_end, Hints...) {
+    return ReplaceInject(arr, t, (size_t) (t_end - t));
+  }
+  // Delete elements [p, p + t_sz) of the buffer or a level,
+  // p is a location found in the set (or merged run)
+  // Return: the location after deleted elements
+  T* Delete(T* p, size_t t_sz) {
+    if (p >= m_buf.Begin() && p < m_buf.End()) {
+      return Erase(m_buf, p, t_sz);
+    }
+    for (size_t i = 0; i < m_depth; ++i) {
+      Set& s = Level(i).m_set;
+      if (p >= s.Begin() && p < s.End()) {
+        return Erase(s, p, t_sz);
+      }
+    }
+    return p;
+  }
+  // Delete elements [p, p_end)
+  T* Delete(T* p, const T* p_end) {
+    return Delete(p, (size_t) (p_end - p));
+  }
+  // Delete key
+  // Return: true - key found and deleted
+  bool Delete(const K& key) {
+    T* p = Find(key);
+    if (p) {
+      Delete(p, 1);
+    }
+    return p != NULL;
+  }
+  // Merge buffer and all levels into the last level
+  // Reads are fastest after compaction, compaction of a
+  // compacted set checks the levels only
+  bool Compact() const {
+    if (!Flush()) {
+      return false;
+    }
+    while (m_depth > 0 && Level(m_depth - 1).m_set.IsEmpty()) {
+      --m_depth;  // Trim emptied levels
+    }
+    bool merged = false;  // Levels merged into the last level
+    for (size_t i = 0; i + 1 < m_depth; ++i) {
+      if (Level(i).m_set.IsEmpty()) {
+        continue;
+      }
+      if (!MergeDown(i, false)) {
+        BuildFilter(i);  // Level i may hold merged elements
+        return false;
+      }
+      merged = true;
+    }
+    return !merged || BuildFilter(m_depth - 1);
+  }
+  // Iterate elements in key order
+  // Input: f - function called as f(const T&)
+  template<typename H>
+  void ForEach(H f) const {
+    const T* pos[MAX_LEVELS + 1];  // Current element of runs
+    const T* end[MAX_LEVELS + 1];  // End of runs
+    size_t n = 0;  // Number of runs
+    pos[n] = m_buf.Begin();
+    end[n++] = m_buf.End();
+    for (size_t i = 0; i < m_depth; ++i) {
+      pos[n] = Level(i).m_set.Begin();
+      end[n++] = Level(i).m_set.End();
+    }
+    while (true) {  // Output smallest head of runs
+      size_t m = n;  // Run of smallest head
+      for (size_t i = 0; i < n; ++i) {
+        if (pos[i] < end[i] &&
+            (m == n || Set::KeyLess(Set::KeyOf(*pos[i]),
+                                    Set::KeyOf(*pos[m])))) {
+          m = i;
+        }
+      }
+      if (m == n) {  // All runs done
+        return;
+      }
+      f(*pos[m]++);
+    }
+  }
+private:
+  // Level of sorted run and its filter
+  struct LevelT {
+    // Constructor
+    LevelT(memory::MMBase* mm)
+      : m_set (0, mm),
+        m_filter (mm) {
+    }
+    Set m_set;  // Sorted run
+    F m_filter;  // Filter of run keys
+  };
+  // Get level i
+  LevelT& Level(size_t i) const {
+    return m_levels.Ptr()[i];
+  }
+  // Check filter of level l, for search keys of key type
+  template<typename Q>
+  static bool MayContain(const LevelT& l, const Q& key) {
+    if constexpr (std::is_same<Q, K>::value) {
+      return l.m_filter.MayContain(key);
+    } else {
+      return true;  // Filter has keys of key type only
+    }
+  }
+  // Merged run, the set is compacted first (the run misses
+  // elements if compaction fails to allocate memory)
+  const Set& Run() const {
+    Compact();
+    return Level(m_depth ? m_depth - 1 : 0).m_set;
+  }
+  // Insert or inject elements of array one by one by f
+  template<typename H, typename G>
+  static bool Each(H* t, size_t t_sz, G f) {
+    for (size_t i = 0; i < t_sz; ++i) {
+      if (!f(t[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Clear injected elements of arr
+  template<typename H>
+  static bool Cleared(H& arr, T* t, size_t t_sz, bool injected) {
+    if (injected) {
+      arr.Delete(t, t_sz);
+    }
+    return injected;
+  }
+  // Delete elements [p, p + t_sz) of run s
+  template<typename S>
+  T* Erase(S& s, T* p, size_t t_sz) {
+    t_sz = JNU_MIN(t_sz, (size_t) (s.End() - p));
+    m_size -= t_sz;
+    return s.Delete(p, t_sz);
+  }
+  // Capacity of level i
+  static size_t Capacity(size_t i) {
+    size_t c = BUF * RATIO;  // Capacity of level 0
+    for (size_t j = 0; j < i && c < (size_t) (-1) / RATIO; ++j) {
+      c *= RATIO;
+    }
+    return c;
+  }
+  // Add new element to buffer, flush buffer if full
+  template<typename H>
+  Res Add(H& t) {
+    if (m_buf.Size() >= BUF && !Flush()) {
+      return Res();
+    }
+    T* p = NULL;  // Added element
+    if constexpr (std::is_const<H>::value) {  // Copy
+      p = *m_buf.Insert(t);
+    } else {  // Move
+      p = *m_buf.Inject(t);
+    }
+    m_size += p != NULL;
+    return Res(p, false);
+  }
+  // Merge buffer into level 0 and cascade full levels
+  bool Flush() const {
+    if (m_buf.IsEmpty()) {
+      return true;
+    }
+    if (!m_levels || !Level(0).m_set.InjectSorted(m_buf.Begin(),
+                                                  m_buf.Size())) {
+      return false;
+    }
+    m_buf.Clear();
+    m_depth = JNU_MAX(m_depth, (size_t) 1);
+    for (size_t i = 0; i + 1 < MAX_LEVELS &&
+                       Level(i).m_set.Size() > Capacity(i); ++i) {
+      if (!MergeDown(i)) {
+        return false;
+      }
+    }
+    return BuildFilter(0);
+  }
+  // Merge level i into level i + 1
+  // Input: filter - build filter of level i + 1 (otherwise
+  //                 left to the caller)
+  bool MergeDown(size_t i, bool filter = true) const {
+    Set& s = Level(i).m_set;
+    if (!Level(i + 1).m_set.InjectSorted(s.Begin(), s.Size())) {
+      return false;
+    }
+    s.Clear();
+    Level(i).m_filter.Reset(0);
+    m_depth = JNU_MAX(m_depth, i + 2);
+    return !filter || BuildFilter(i + 1);
+  }
+  // Build filter of level i
+  bool BuildFilter(size_t i) const {
+    LevelT& l = Level(i);
+    if (!l.m_filter.Reset(l.m_set.Size())) {
+      return false;
+    }
+    for (const T* p = l.m_set.Begin(); p < l.m_set.End(); ++p) {
+      l.m_filter.Add(Set::KeyOf(*p));
+    }
+    return true;
+  }
+  mutable Buf m_buf;  // Write buffer (merged by compaction)
+  memory::Obj<LevelT> m_levels;  // Levels of sorted runs
+  mutable size_t m_depth;  // Number of levels in use
+  size_t m_size;  // Number of elements
+};
+// Log-structured set (underline element as key)
+// C - underline array type of levels
+// LESS - Comparison of element
+// BUF - size of write buffer
+// F - filter type of levels
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type&,
+                                const typename C::Type&)) NULL,
+         size_t BUF = 64,
+         typename F = LsmNoFilter<typename C::Type>>
+using LsmArraySet = LsmArraySetT<C, typename C::Type,
+                                 (const typename C::Type& (*)
+                                 (const typename C::Type)) NULL,
+                                 LESS, BUF, F>;
+// Log-structured map (element is a pair object)
+// Using first object as key
+template<typename C,
+         auto LESS = (bool (*) (const typename C::Type::FirstType&,
+                                const typename C::Type::FirstType&)) NULL,
+         size_t BUF = 64,
+         typename F = LsmNoFilter<typename C::Type::FirstType>>
+using LsmArrayMap = LsmArraySetT<C,
+                                 typename C::Type::FirstType,
+                                 C::Type::GetFirst,
+                                 LESS, BUF, F>;
+}
+
+#endif
@@ -0,0 +1,288 @@
+// By JNI
+// Parallel algorithms on arrays
+// Input range is split into chunks of at least grain size,
+// chunks run as tasks of a thread pool and the calling
+// thread runs the first chunk then helps the rest
+// Small input (not larger than grain) runs serially in the
+// calling thread
+// Algorithms work on raw ranges [first, last) or on any
+// array (static, dynamic or hybrid)
+
+#ifndef JNU_PARALLEL_H
+#define JNU_PARALLEL_H
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include "jnu_defines.h"
+#include "jnu_array.h"
+#include "jnu_thread_pool.h"
+
+namespace jnu {
+namespace parallel {
+const static size_t GRAIN = 4096;  // Default grain size
+const static size_t CHUNKS_PER_THREAD = 4;  // Chunks for load balance
+// Number of chunks for n items
+// Return: 1 if items should run serially
+static inline size_t Chunks(const ThreadPool& p, size_t n, size_t grain) {
+  grain = JNU_MAX(grain, (size_t) 1);
+  if (n <= grain || !p.Size()) {
+    return 1;
+  }
+  return JNU_MIN((n + grain - 1) / grain,
+                 (p.Size() + 1) * CHUNKS_PER_THREAD);
+}
+// Resize array to size
+template<typename C>
+bool Fit(ArrayImp<C>& arr, size_t sz) {
+  if (arr.Size() < sz) {
+    return arr.Expand(arr.End(), sz - arr.Size()) != NULL;
+  }
+  arr.Delete(arr.Begin() + sz, arr.Size() - sz);
+  return true;
+}
+// Run function on every chunk, balanced split of n items
+// Input: chunks - number of chunks
+//        f - function of (chunk index, start, end)
+template<typename F>
+void RunChunks(ThreadPool& p, size_t n, size_t chunks, F& f) {
+  size_t step = n / chunks;  // Base chunk size
+  size_t rem = n % chunks;  // First rem chunks get one more
+  ThreadPool::Group g;
+  for (size_t c = 1; c < chunks; ++c) {
+    size_t lo = c * step + JNU_MIN(c, rem);
+    size_t hi = lo + step + (c < rem);
+    p.Submit(g, [&f, c, lo, hi]() { f(c, lo, hi); });
+  }
+  f(0, 0, step + (rem > 0));  // First chunk in calling thread
+  p.Wait(g);
+}
+// Apply function on each item of range
+// Input: p - thread pool
+//        first, last - range
+//        f - function of (T&)
+//        grain - minimum items per chunk
+template<typename T, typename F>
+void ForEach(ThreadPool& p, T* first, T* last, F f,
+             size_t grain = GRAIN) {
+  size_t n = last - first;  // Number of items
+  auto run = [first, &f](size_t c, size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; ++i) {
+      f(first[i]);
+    }
+  };
+  RunChunks(p, n, Chunks(p, n, grain), run);
+}
+// Apply function on each item of array
+template<typename C, typename F>
+void ForEach(ThreadPool& p, const ArrayImp<C>& arr, F f,
+             size_t grain = GRAIN) {
+  ForEach(p, arr.Begin(), arr.End(), f, grain);
+}
+// Transform range into output
+// Input: first, last - input range
+//        out - output range (same size as input)
+//        f - function of (const T&), return output item
+template<typename T, typename O, typename F>
+void Transform(ThreadPool& p, const T* first, const T* last, O* out,
+               F f, size_t grain = GRAIN) {
+  size_t n = last - first;  // Number of items
+  auto run = [first, out, &f](size_t c, size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; ++i) {
+      out[i] = f(first[i]);
+    }
+  };
+  RunChunks(p, n, Chunks(p, n, grain), run);
+}
+// Transform array into output array
+// Output array is resized to input size
+// Return: true - success, false - fail to resize output
+template<typename C, typename D, typename F>
+bool Transform(ThreadPool& p, const ArrayImp<C>& in, ArrayImp<D>& out,
+               F f, size_t grain = GRAIN) {
+  if (!Fit(out, in.Size())) {
+    return false;
+  }
+  Transform(p, in.Begin(), in.End(), out.Begin(), f, grain);
+  return true;
+}
+// Reduce range with associative operator
+// Items of each chunk are reduced in order, then chunk
+// results are combined in order, so a non-commutative
+// operator is fine
+// Input: first, last - range
+//        init - initial value
+//        op - operator of (R, T) and (R, R), return R
+// Return: reduced value
+template<typename T, typename R, typename OP>
+R Reduce(ThreadPool& p, const T* first, const T* last, R init, OP op,
+         size_t grain = GRAIN) {
+  size_t n = last - first;  // Number of items
+  size_t chunks = Chunks(p, n, grain);  // Number of chunks
+  if (chunks <= 1) {  // Serial
+    for (const T* t = first; t < last; ++t) {
+      init = op(init, *t);
+    }
+    return init;
+  }
+  DArray<R, ARR_OBJ_ALLOC, 1> part;  // Result of each chunk
+  if (!part.Expand(part.Begin(), chunks)) {
+    return Reduce(p, first, last, init, op, n);  // Serial
+  }
+  R* res = part.Begin();
+  auto run = [first, res, &op](size_t c, size_t lo, size_t hi) {
+    R r = first[lo];
+    for (size_t i = lo + 1; i < hi; ++i) {
+      r = op(r, first[i]);
+    }
+    res[c] = r;
+  };
+  RunChunks(p, n, chunks, run);
+  for (size_t c = 0; c < chunks; ++c) {
+    init = op(init, res[c]);
+  }
+  return init;
+}
+// Reduce array with associative operator
+template<typename C, typename R, typename OP>
+R Reduce(ThreadPool& p, const ArrayImp<C>& arr, R init, OP op,
+         size_t grain = GRAIN) {
+  typedef typename ArrayImp<C>::Type T;  // Item type
+  return Reduce(p, (const T*) arr.Begin(), arr.End(), init, op, grain);
+}
+// Inclusive scan of range with associative operator
+// out[i] = first[0] op first[1] op ... op first[i]
+// Chunks are reduced in parallel, chunk offsets are scanned
+// serially, then chunks are scanned in parallel
+// Input: first, last - input range
+//        out - output range (same size as input, can be
+//              same as input)
+//        op - operator of (T, T), return T
+template<typename T, typename OP>
+void InclusiveScan(ThreadPool& p, const T* first, const T* last, T* out,
+                   OP op, size_t grain = GRAIN) {
+  size_t n = last - first;  // Number of items
+  size_t chunks = Chunks(p, n, grain);  // Number of chunks
+  DArray<T, ARR_OBJ_ALLOC, 1> part;  // Offset of each chunk
+  if (chunks <= 1 || !part.Expand(part.Begin(), chunks)) {  // Serial
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = i ? op(out[i - 1], first[i]) : first[i];
+    }
+    return;
+  }
+  T* off = part.Begin();
+  auto sum = [first, off, &op](size_t c, size_t lo, size_t hi) {
+    T r = first[lo];
+    for (size_t i = lo + 1; i < hi; ++i) {
+      r = op(r, first[i]);
+    }
+    off[c] = r;
+  };
+  RunChunks(p, n, chunks, sum);
+  for (size_t c = 1; c < chunks; ++c) {  // Inclusive offsets
+    off[c] = op(off[c - 1], off[c]);
+  }
+  auto scan = [first, out, off, &op](size_t c, size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; ++i) {
+      out[i] = i > lo ? op(out[i - 1], first[i]) :
+               c ? op(off[c - 1], first[i]) : first[i];
+    }
+  };
+  RunChunks(p, n, chunks, scan);
+}
+// Inclusive scan of array into output array
+// Output array is resized to input size
+// Return: true - success, false - fail to resize output
+template<typename C, typename D, typename OP>
+bool InclusiveScan(ThreadPool& p, const ArrayImp<C>& in,
+                   ArrayImp<D>& out, OP op, size_t grain = GRAIN) {
+  if (!Fit(out, in.Size())) {
+    return false;
+  }
+  typedef typename ArrayImp<C>::Type T;  // Input item type
+  InclusiveScan(p, (const T*) in.Begin(), in.End(), out.Begin(), op, grain);
+  return true;
+}
+// Split point of stable merge of a and b
+// Items of a go before equal items of b
+// Input: o - number of merged items before split
+// Return: number of items of a before split
+template<typename T, typename LT>
+size_t MergeSplit(const T* a, size_t na, const T* b, size_t nb,
+                  size_t o, LT& less) {
+  size_t lo = o > nb ? o - nb : 0;  // Minimum items from a
+  size_t hi = JNU_MIN(o, na);  // Maximum items from a
+  while (lo < hi) {  // Largest i with a[i - 1] before b[o - i]
+    size_t i = lo + (hi - lo + 1) / 2;
+    if (o - i >= nb || !less(b[o - i], a[i - 1])) {
+      lo = i;
+    } else {
+      hi = i - 1;
+    }
+  }
+  return lo;
+}
+// Stable sort of range
+// Chunks are sorted in parallel, then sorted runs are merged
+// pairwise, each pair merge is split into pieces of balanced
+// size so all threads stay busy in the last rounds
+// Input: first, last - range
+//        less - comparison of (const T&, const T&)
+// Items need to be default constructible and movable
+template<typename T, typename LT>
+void Sort(ThreadPool& p, T* first, T* last, LT less,
+          size_t grain = GRAIN) {
+  size_t n = last - first;  // Number of items
+  size_t chunks = Chunks(p, n, grain);  // Number of sorted runs
+  DArray<T, ARR_OBJ_ALLOC, 1> buf;  // Merge buffer
+  DArray<size_t, ARR_MEM_ALLOC, 1> runs;  // Run bounds
+  if (chunks <= 1 || !buf.Expand(buf.Begin(), n) ||
+      !runs.Expand(runs.Begin(), chunks + 1)) {  // Serial
+    std::stable_sort(first, last, less);
+    return;
+  }
+  size_t* rb = runs.Begin();
+  auto sort = [first, rb, &less](size_t c, size_t lo, size_t hi) {
+    std::stable_sort(first + lo, first + hi, less);
+    rb[c] = lo;
+  };
+  RunChunks(p, n, chunks, sort);
+  rb[chunks] = n;
+  T* src = first;  // Runs to merge
+  T* dst = buf.Begin();  // Merged runs
+  for (size_t nr = chunks; nr > 1; nr = (nr + 1) / 2) {
+    size_t pairs = (nr + 1) / 2;  // Merges of this round
+    size_t parts = (chunks + pairs - 1) / pairs;  // Pieces per merge
+    auto merge = [=, &less](size_t c, size_t lo, size_t hi) {
+      size_t r = c / parts * 2;  // First run of pair
+      size_t k = c % parts;  // Piece of merge
+      size_t a = rb[r];  // Start of first run
+      size_t m = rb[JNU_MIN(r + 1, nr)];  // Start of second run
+      size_t e = rb[JNU_MIN(r + 2, nr)];  // End of second run
+      size_t o0 = (e - a) * k / parts;  // Piece in output
+      size_t o1 = (e - a) * (k + 1) / parts;
+      size_t i0 = MergeSplit(src + a, m - a, src + m, e - m, o0, less);
+      size_t i1 = MergeSplit(src + a, m - a, src + m, e - m, o1, less);
+      std::merge(std::make_move_iterator(src + a + i0),
+                 std::make_move_iterator(src + a + i1),
+                 std::make_move_iterator(src + m + o0 - i0),
+                 std::make_move_iterator(src + m + o1 - i1),
+                 dst + a + o0, less);
+    };
+    RunChunks(p, pairs * parts, pairs * parts, merge);
+    for (size_t r = 1; r <= pairs; ++r) {  // Merged run bounds
+      rb[r] = rb[JNU_MIN(r * 2, nr)];
+    }
+    std::swap(src, dst);
+  }
+  if (src != first) {  // Move result back
+    auto back = [first, src](size_t c, size_t lo, size_t hi) {
+      std::move(src + lo, src + hi, first + lo);
+    };
+    RunChunks(p, n, chunks, back);
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,212 @@
+// By JNI
+// Learned (piecewise linear) search index of sorted set with
+// integral keys, in the style of PGM index
+// Positions of keys are approximated by linear segments, each
+// segment is fitted by a shrinking cone from its first key, so
+// every key is predicted within EPS positions of its rank
+// Segments are indexed recursively by segments over their first
+// keys, until one segment is left at the root, a lookup is a
+// model evaluation plus a search of 2 * EPS keys per level
+// The index is a companion of the set (SetIndex), it is
+// rebuilt after writes
+
+#ifndef JNU_PGM_H
+#define JNU_PGM_H
+
+#include <type_traits>
+#include "jnu_defines.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+#include "jnu_array_set.h"
+#include "jnu_search.h"
+#include "jnu_set_index.h"
+
+namespace jnu {
+// Learned index of sorted set
+// Template arguments:
+// S - sorted set type (ArraySetT) with integral keys
+// EPS - maximum prediction error in positions
+template<typename S, size_t EPS = 32>
+class PgmIndex : public SetIndex<S> {
+  typedef SetIndex<S> Base;  // Companion index base
+  typedef typename S::Type T;  // Element type
+  typedef typename S::Key K;  // Key type
+  typedef typename S::Res Res;  // Search result
+  using Base::m_set;
+  static_assert(std::is_integral<K>::value, "Keys must be integral");
+  static_assert(EPS > 0, "Error bound must be positive");
+  typedef typename std::make_unsigned<K>::type U;  // Key distance
+  // Linear segment
+  struct Seg {
+    double m_slope;  // Positions per key
+    size_t m_pos;  // Position of first key
+  };
+  // First keys and segments of all levels, bottom level first
+  typedef DArray<K, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Keys;
+  typedef DArray<Seg, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Segs;
+  const static size_t MAX_LEVELS = 64;  // Segments halve per level
+public:
+  // Constructor, index is empty until rebuilt
+  // Input: set - the indexed set
+  //        mm - memory manager of index
+  PgmIndex(const S& set, memory::MMBase* mm = &memory::MM_BUILDIN)
+    : Base (set),
+      m_keys (0, mm),
+      m_segs (0, mm),
+      m_levels (0) {
+    m_level[0] = 0;
+  }
+  // Deconstructor
+  ~PgmIndex() {
+  }
+  // Keep unique, no copy constructor allowed
+  PgmIndex(const PgmIndex& i) = delete;
+  // Keep unique, no assign operator allowed
+  PgmIndex& operator=(const PgmIndex& i) = delete;
+  // Rebuild index
+  // Return: true - success, false - fail to allocate memory
+  bool Rebuild() {
+    m_keys.Clear();
+    m_segs.Clear();
+    m_levels = 0;
+    Base::Unbuilt();  // Unusable until completed
+    size_t n = m_set.Size();  // Number of elements
+    const T* d = m_set.Begin();  // Sorted elements
+    if (!n) {
+      Base::Built();
+      return true;
+    }
+    if (!Fit(n, [d](size_t i) { return S::KeyOf(d[i]); })) {
+      return false;
+    }
+    while (Count(m_levels - 1) > 1 && m_levels < MAX_LEVELS) {
+      size_t b = m_level[m_levels - 1];  // Fit upper level
+      if (!Fit(Count(m_levels - 1),
+               [this, b](size_t i) { return m_keys[b + i]; })) {
+        return false;
+      }
+    }
+    Base::Built();
+    return true;
+  }
+  // Number of segments of all levels
+  size_t Segments() const {
+    return m_segs.Size();
+  }
+  // Number of levels
+  size_t Levels() const {
+    return m_levels;
+  }
+  // Locate key
+  // Return: the location of key,
+  //         if not found, the location the key should
+  //         be inserted
+  Res Locate(const K& key) const {
+    size_t n = m_set.Size();  // Number of elements
+    T* d = m_set.Begin();  // Sorted elements
+    size_t p = Base::NPOS;  // Lower bound of key
+    if (Base::IsUsable()) {
+      size_t l = m_levels - 1;  // Root level
+      size_t j = Last(l, key, Count(l) / 2);  // Segment of key
+      for (; l > 0; --l) {  // Descend levels
+        j = Last(l - 1, key, Predict(l, j, key, Count(l - 1)));
+      }
+      p = Predict(0, j, key, n);  // Position in set
+      size_t a = p > EPS + 2 ? p - EPS - 2 : 0;  // Search window
+      size_t e = JNU_MIN(p + EPS + 3, n);
+      p = search::LowerBound(d + a, d + e, key,
+                             [](const T& t) { return S::KeyOf(t); }) - d;
+    }
+    return Base::Validate(key, p);
+  }
+  // Find key
+  // Return: the location if found
+  //         invalid location if not found
+  T* Find(const K& key) const {
+    Res r = Locate(key);
+    return r.Found() ? *r : NULL;
+  }
+private:
+  // Number of segments of level l
+  size_t Count(size_t l) const {
+    return m_level[l + 1] - m_level[l];
+  }
+  // Fit segments of a level over n sorted keys, by shrinking
+  // the cone of slopes from the first key of segment
+  // Input: n - number of keys
+  //        key_of - function getting key i
+  template<typename F>
+  bool Fit(size_t n, F key_of) {
+    size_t s = 0;  // First key of segment
+    K x0 = key_of(0);
+    double lo = 0;  // Cone of slopes
+    double hi = 0;
+    for (size_t i = 1; i <= n; ++i) {
+      if (i < n) {
+        double dx = (double) (U) ((U) key_of(i) - (U) x0);
+        double dy = (double) (i - s);
+        double s_lo = (dy - EPS) / dx;
+        double s_hi = (dy + EPS) / dx;
+        if (i == s + 1) {  // Second key opens the cone
+          lo = JNU_MAX(s_lo, 0.0);
+          hi = s_hi;
+          continue;
+        }
+        if (JNU_MAX(lo, s_lo) <= JNU_MIN(hi, s_hi)) {  // Shrink
+          lo = JNU_MAX(lo, s_lo);
+          hi = JNU_MIN(hi, s_hi);
+          continue;
+        }
+      }
+      Seg seg = {i == s + 1 ? 0.0 : (lo + hi) / 2, s};  // Close
+      if (!m_keys.Insert(m_keys.End(), x0, 1) ||
+          !m_segs.Insert(m_segs.End(), seg, 1)) {
+        return false;
+      }
+      if (i < n) {  // Open next segment
+        s = i;
+        x0 = key_of(i);
+      }
+    }
+    m_level[++m_levels] = m_segs.Size();
+    return true;
+  }
+  // Predict position of key by segment j of level l
+  // A key after the last key of segment is before the first
+  // key of next segment, so prediction is capped by its position
+  // Input: lim - number of positions of lower level
+  size_t Predict(size_t l, size_t j, const K& key, size_t lim) const {
+    size_t g = m_level[l] + j;  // Segment in all levels
+    const Seg& seg = m_segs[g];
+    const K& x0 = m_keys[g];
+    if (!(x0 < key)) {
+      return seg.m_pos;
+    }
+    if (j + 1 < Count(l)) {
+      lim = m_segs[g + 1].m_pos;
+    }
+    double p = seg.m_pos + seg.m_slope * (double) (U) ((U) key - (U) x0);
+    return p < (double) lim ? (size_t) p : lim;
+  }
+  // Last segment of level l with first key not greater than key
+  // (or the first segment), searched around predicted p first
+  size_t Last(size_t l, const K& key, size_t p) const {
+    K* k = m_keys.Begin() + m_level[l];  // First keys of level
+    size_t n = Count(l);
+    size_t a = p > EPS + 2 ? p - EPS - 2 : 0;  // Search window
+    size_t e = JNU_MIN(p + EPS + 3, n);
+    size_t lb = search::LowerBound(k + a, k + e, key) - k;
+    if (!((lb > a || !a || k[a - 1] < key) &&
+          (lb < e || e == n || !(k[e] < key)))) {
+      lb = search::LowerBound(k, k + n, key) - k;  // Out of window
+    }
+    return lb < n && !(key < k[lb]) ? lb : (lb ? lb - 1 : 0);
+  }
+  Keys m_keys;  // First keys of segments
+  Segs m_segs;  // Segments
+  size_t m_level[MAX_LEVELS + 1];  // First segment of levels
+  size_t m_levels;  // Number of levels
+};
+}
+
+#endif
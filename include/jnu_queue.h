@@ -0,0 +1,424 @@
+// By JNI
+// Implementation of bounded concurrent queues on the base
+// of array storage
+// Items are stored in pre-allocated power of 2 ring buffers,
+// indexes are shared between threads through atomic variables
+// placed on separate cache lines
+
+#ifndef JNU_QUEUE_H
+#define JNU_QUEUE_H
+
+#include <stdint.h>
+#include "jnu_defines.h"
+#include "jnu_atomic.h"
+#include "jnu_memory.h"
+#include "jnu_array.h"
+
+namespace jnu {
+// Round up to power of 2
+static inline size_t RoundPow2(size_t sz) {
+  size_t r = 1;
+  while (r < sz && r << 1) {
+    r <<= 1;
+  }
+  return r < sz ? 0 : r;
+}
+// Single producer single consumer ring buffer
+// Each side keeps a cached copy of the other side's index,
+// so the shared index is only read when the cache says the
+// ring is full (or empty)
+// Batch push and pop copy (or move) contiguous runs with the
+// array's memory/object model and publish once
+// Template arguments:
+// C - array storage (static or dynamic array)
+// N - static capacity (power of 2), 0 for capacity
+//     given on construction
+template<typename C, size_t N>
+class SpscRingT {
+  typedef typename C::Type T;  // Item type
+  typedef typename C::Alloc A;  // Memory/object model
+  static_assert(JNU_IS_POW_2(N), "ring capacity must be power of 2");
+public:
+  typedef T Type;  // Item type
+  typedef A Alloc;  // Memory/object model
+  // Constructor
+  // Input: sz - ring capacity (rounded up to power of 2),
+  //             it is ignored if static capacity N is given
+  //        mm - memory manager for dynamic array
+  SpscRingT(size_t sz = N,
+            memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_tail (0),
+      m_head_cache (0),
+      m_head (0),
+      m_tail_cache (0),
+      m_data (0, mm),
+      m_mask (0) {
+    size_t cap = RoundPow2(N ? N : sz);  // Ring capacity
+    // Allocate and initialize all slots
+    if (cap && m_data.Expand(m_data.Begin(), cap)) {
+      m_mask = cap - 1;
+    }
+  }
+  // Deconstructor
+  ~SpscRingT() {
+  }
+  // Keep unique, no copy constructor allowed
+  SpscRingT(const SpscRingT& r) = delete;
+  // Keep unique, no assign operator allowed
+  SpscRingT& operator=(const SpscRingT& r) = delete;
+  // Ring capacity
+  size_t Capacity() const {
+    return m_data.Size();
+  }
+  // Number of items in ring (snapshot)
+  size_t Size() const {
+    return m_tail.Load(atomic::MO_ACQUIRE) - m_head.Load(atomic::MO_ACQUIRE);
+  }
+  // Check if ring is empty (snapshot)
+  bool IsEmpty() const {
+    return Size() == 0;
+  }
+  // Push (copy) single item (producer)
+  // Return: true - pushed, false - ring is full
+  bool Push(const T& t) {
+    return Put<const T, A::template Copy<T>>(&t, 1) == 1;
+  }
+  // Inject (move) single item (producer)
+  bool Inject(T& t) {
+    return Put<T, A::template Move<T>>(&t, 1) == 1;
+  }
+  // Push (copy) array of items (producer)
+  // Input: t, t_sz - input array
+  // Return: number of items pushed
+  size_t PushBatch(const T* t, size_t t_sz) {
+    return Put<const T, A::template Copy<T>>(t, t_sz);
+  }
+  // Inject (move) array of items (producer)
+  size_t InjectBatch(T* t, size_t t_sz) {
+    return Put<T, A::template Move<T>>(t, t_sz);
+  }
+  // Pop single item (consumer)
+  // Return: true - popped, false - ring is empty
+  bool Pop(T& t) {
+    return PopBatch(&t, 1) == 1;
+  }
+  // Pop (move) items into array (consumer)
+  // Input: t, t_sz - output array
+  // Return: number of items popped
+  size_t PopBatch(T* t, size_t t_sz) {
+    size_t head = m_head.Load(atomic::MO_RELAXED);  // Own index
+    size_t avail = m_tail_cache - head;  // Items by cached tail
+    if (avail < t_sz) {  // Refresh cached tail
+      m_tail_cache = m_tail.Load(atomic::MO_ACQUIRE);
+      avail = m_tail_cache - head;
+    }
+    size_t n = JNU_MIN(avail, t_sz);  // Items to pop
+    if (n) {
+      size_t i = head & m_mask;  // Start slot
+      size_t run = JNU_MIN(n, Capacity() - i);  // First contiguous run
+      A::Move(t, m_data.Data() + i, run);
+      A::Move(t + run, m_data.Data(), n - run);  // Wrapped run
+      m_head.Store(head + n, atomic::MO_RELEASE);  // Publish once
+    }
+    return n;
+  }
+private:
+  // Put items into ring (producer)
+  // H - input item type (const for copy)
+  // F - copy or move function of the memory/object model
+  template<typename H, void (*F)(T*, H*, size_t)>
+  size_t Put(H* t, size_t t_sz) {
+    size_t cap = Capacity();  // Ring capacity
+    size_t tail = m_tail.Load(atomic::MO_RELAXED);  // Own index
+    size_t space = cap - (tail - m_head_cache);  // Space by cached head
+    if (space < t_sz) {  // Refresh cached head
+      m_head_cache = m_head.Load(atomic::MO_ACQUIRE);
+      space = cap - (tail - m_head_cache);
+    }
+    size_t n = JNU_MIN(space, t_sz);  // Items to put
+    if (n) {
+      size_t i = tail & m_mask;  // Start slot
+      size_t run = JNU_MIN(n, cap - i);  // First contiguous run
+      F(m_data.Data() + i, t, run);
+      F(m_data.Data(), t + run, n - run);  // Wrapped run
+      m_tail.Store(tail + n, atomic::MO_RELEASE);  // Publish once
+    }
+    return n;
+  }
+  // Producer side, on its own cache line
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<size_t> m_tail;  // Write index
+  size_t m_head_cache;  // Cached read index
+  // Consumer side, on its own cache line
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<size_t> m_head;  // Read index
+  size_t m_tail_cache;  // Cached write index
+  // Read only after construction
+  alignas(JNU_CACHE_LINE_SZ) C m_data;  // Ring storage
+  size_t m_mask;  // Index mask
+};
+// Define of static single producer single consumer ring
+// T - item type
+// N - capacity (power of 2)
+// A - memory/object model
+template<typename T, size_t N, typename A>
+using SpscRing = SpscRingT<SArray<T, N, A>, N>;
+// Define of dynamic single producer single consumer ring
+// capacity is given on construction
+template<typename T, typename A, memory::Align AL = 8>
+using DSpscRing = SpscRingT<DArray<T, A, 1, AL>, 0>;
+// Multiple producers multiple consumers bounded queue
+// Each cell carries a sequence number telling whether it is
+// ready for the producer (seq == pos) or for the consumer
+// (seq == pos + 1) of the lap, so producers and consumers only
+// contend on their own index and the cell they claimed
+// Cells are cache line aligned to avoid false sharing
+// Template arguments:
+// T - item type
+// A - memory/object model
+template<typename T, typename A>
+class MpmcQueue {
+  // Queue cell
+  // Sequence number is plain to keep the cell copyable by
+  // the memory/object model, it is accessed atomically
+  struct alignas(JNU_CACHE_LINE_SZ) Cell {
+    size_t m_seq;  // Sequence number
+    T m_val;  // Item
+  };
+  // Cells storage, aligned on cache line
+  typedef DArray<Cell, A, 1, JNU_CACHE_LINE_SZ> Cells;
+public:
+  typedef T Type;  // Item type
+  typedef A Alloc;  // Memory/object model
+  // Constructor
+  // Input: sz - queue capacity (rounded up to power of 2)
+  //        mm - memory manager of cells
+  MpmcQueue(size_t sz, memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_tail (0),
+      m_head (0),
+      m_cells (0, mm),
+      m_mask (0) {
+    size_t cap = RoundPow2(JNU_MAX(sz, (size_t) 2));  // Queue capacity
+    if (cap && m_cells.Expand(m_cells.Begin(), cap)) {
+      for (size_t i = 0; i < cap; ++i) {  // Ready for first lap
+        SetSeq(m_cells[i], i, atomic::MO_RELAXED);
+      }
+      m_mask = cap - 1;
+    }
+  }
+  // Deconstructor
+  ~MpmcQueue() {
+  }
+  // Keep unique, no copy constructor allowed
+  MpmcQueue(const MpmcQueue& q) = delete;
+  // Keep unique, no assign operator allowed
+  MpmcQueue& operator=(const MpmcQueue& q) = delete;
+  // Queue capacity
+  size_t Capacity() const {
+    return m_cells.Size();
+  }
+  // Number of items in queue (snapshot)
+  size_t Size() const {
+    size_t head = m_head.Load(atomic::MO_ACQUIRE);  // Read first
+    size_t tail = m_tail.Load(atomic::MO_ACQUIRE);
+    return tail > head ? tail - head : 0;
+  }
+  // Check if queue is empty (snapshot)
+  bool IsEmpty() const {
+    return Size() == 0;
+  }
+  // Push (copy) item
+  // Return: true - pushed, false - queue is full
+  bool Push(const T& t) {
+    return Put<const T, A::template Copy<T>>(&t);
+  }
+  // Inject (move) item
+  bool Inject(T& t) {
+    return Put<T, A::template Move<T>>(&t);
+  }
+  // Pop (move) item
+  // Return: true - popped, false - queue is empty
+  bool Pop(T& t) {
+    size_t pos = m_head.Load(atomic::MO_RELAXED);  // Read position
+    Cell* cell = NULL;  // Claimed cell
+    while (m_mask) {
+      cell = &m_cells[pos & m_mask];
+      size_t seq = Seq(*cell);
+      intptr_t dif = (intptr_t) seq - (intptr_t) (pos + 1);
+      if (dif == 0) {  // Filled in this lap, try to claim
+        if (m_head.CompareExchangeWeak(pos, pos + 1,
+                                       atomic::MO_RELAXED,
+                                       atomic::MO_RELAXED)) {
+          A::Move(&t, &cell->m_val, 1);
+          // Release cell to producer of next lap
+          SetSeq(*cell, pos + m_mask + 1, atomic::MO_RELEASE);
+          return true;
+        }
+      } else if (dif < 0) {  // Not filled yet, queue is empty
+        return false;
+      } else {  // Claimed by other consumer, reload
+        pos = m_head.Load(atomic::MO_RELAXED);
+      }
+    }
+    return false;
+  }
+private:
+  // Load sequence number of cell
+  static size_t Seq(const Cell& cell) {
+    return __atomic_load_n(&cell.m_seq, atomic::MO_ACQUIRE);
+  }
+  // Store sequence number of cell
+  static void SetSeq(Cell& cell, size_t seq, atomic::MemoryOrder mo) {
+    __atomic_store_n(&cell.m_seq, seq, mo);
+  }
+  // Put item into queue
+  // H - input item type (const for copy)
+  // F - copy or move function of the memory/object model
+  template<typename H, void (*F)(T*, H*, size_t)>
+  bool Put(H* t) {
+    size_t pos = m_tail.Load(atomic::MO_RELAXED);  // Write position
+    Cell* cell = NULL;  // Claimed cell
+    while (m_mask) {
+      cell = &m_cells[pos & m_mask];
+      size_t seq = Seq(*cell);
+      intptr_t dif = (intptr_t) seq - (intptr_t) pos;
+      if (dif == 0) {  // Free in this lap, try to claim
+        if (m_tail.CompareExchangeWeak(pos, pos + 1,
+                                       atomic::MO_RELAXED,
+                                       atomic::MO_RELAXED)) {
+          F(&cell->m_val, t, 1);
+          SetSeq(*cell, pos + 1, atomic::MO_RELEASE);  // Publish
+          return true;
+        }
+      } else if (dif < 0) {  // Not consumed yet, queue is full
+        return false;
+      } else {  // Claimed by other producer, reload
+        pos = m_tail.Load(atomic::MO_RELAXED);
+      }
+    }
+    return false;
+  }
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<size_t> m_tail;  // Write index
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<size_t> m_head;  // Read index
+  // Read only after construction
+  alignas(JNU_CACHE_LINE_SZ) Cells m_cells;  // Queue cells
+  size_t m_mask;  // Index mask
+};
+// Chase-Lev work stealing deque of item pointers
+// The owner thread pushes and pops at bottom (LIFO), other
+// threads steal from top (FIFO), only the last item is
+// contended between owner and thieves
+// Capacity is fixed, push fails when deque is full
+// Template arguments:
+// T - item type, pointers of items are stored
+template<typename T>
+class WorkStealDeque {
+  // Slots storage
+  typedef DArray<T*, ARR_MEM_ALLOC, 1, JNU_CACHE_LINE_SZ> Slots;
+public:
+  typedef T Type;  // Item type
+  // Constructor
+  // Input: sz - deque capacity (rounded up to power of 2)
+  //        mm - memory manager of slots
+  WorkStealDeque(size_t sz, memory::MMBase* mm = &memory::MM_BUILDIN)
+    : m_top (0),
+      m_bottom (0),
+      m_slots (0, mm),
+      m_mask (0) {
+    size_t cap = RoundPow2(sz);  // Deque capacity
+    if (cap && m_slots.Expand(m_slots.Begin(), cap)) {
+      m_mask = cap - 1;
+    }
+  }
+  // Deconstructor
+  ~WorkStealDeque() {
+  }
+  // Keep unique, no copy constructor allowed
+  WorkStealDeque(const WorkStealDeque& d) = delete;
+  // Keep unique, no assign operator allowed
+  WorkStealDeque& operator=(const WorkStealDeque& d) = delete;
+  // Deque capacity
+  size_t Capacity() const {
+    return m_slots.Size();
+  }
+  // Number of items (snapshot)
+  size_t Size() const {
+    int64_t top = m_top.Load(atomic::MO_ACQUIRE);  // Read first
+    int64_t bottom = m_bottom.Load(atomic::MO_ACQUIRE);
+    return bottom > top ? bottom - top : 0;
+  }
+  // Check if deque is empty (snapshot)
+  bool IsEmpty() const {
+    return Size() == 0;
+  }
+  // Push item at bottom (owner)
+  // Return: true - pushed, false - deque is full
+  bool Push(T* t) {
+    int64_t bottom = m_bottom.Load(atomic::MO_RELAXED);
+    int64_t top = m_top.Load(atomic::MO_ACQUIRE);
+    if (bottom - top >= (int64_t) Capacity()) {
+      return false;  // Full
+    }
+    SetSlot(bottom, t);
+    atomic::ThreadFence(atomic::MO_RELEASE);  // Slot before bottom
+    m_bottom.Store(bottom + 1, atomic::MO_RELAXED);
+    return true;
+  }
+  // Pop item at bottom (owner)
+  // Return: item, NULL if deque is empty
+  T* Pop() {
+    int64_t bottom = m_bottom.Load(atomic::MO_RELAXED) - 1;
+    m_bottom.Store(bottom, atomic::MO_RELAXED);  // Reserve bottom
+    atomic::ThreadFence(atomic::MO_SEQ_CST);  // Against thieves' top
+    int64_t top = m_top.Load(atomic::MO_RELAXED);
+    T* t = NULL;  // Popped item
+    if (top <= bottom) {  // Not empty
+      t = Slot(bottom);
+      if (top == bottom) {  // Last item, race with thieves
+        // Strong exchange, a spurious failure would leave the
+        // item in deque while reporting it empty
+        if (!m_top.CompareExchangeStrong(top, top + 1,
+                                         atomic::MO_SEQ_CST,
+                                         atomic::MO_RELAXED)) {
+          t = NULL;  // Lost to a thief
+        }
+        m_bottom.Store(bottom + 1, atomic::MO_RELAXED);
+      }
+    } else {  // Empty, restore bottom
+      m_bottom.Store(bottom + 1, atomic::MO_RELAXED);
+    }
+    return t;
+  }
+  // Steal item at top (any thread)
+  // Return: item, NULL if deque is empty or lost the race
+  T* Steal() {
+    int64_t top = m_top.Load(atomic::MO_ACQUIRE);
+    atomic::ThreadFence(atomic::MO_SEQ_CST);  // Against owner's bottom
+    int64_t bottom = m_bottom.Load(atomic::MO_ACQUIRE);
+    if (top < bottom) {  // Not empty
+      T* t = Slot(top);
+      // Strong exchange, fails only if another thread took it
+      if (m_top.CompareExchangeStrong(top, top + 1,
+                                      atomic::MO_SEQ_CST,
+                                      atomic::MO_RELAXED)) {
+        return t;
+      }
+    }
+    return NULL;
+  }
+private:
+  // Load slot of position
+  T* Slot(int64_t pos) const {
+    return __atomic_load_n(&m_slots[pos & m_mask], atomic::MO_RELAXED);
+  }
+  // Store slot of position
+  void SetSlot(int64_t pos, T* t) {
+    __atomic_store_n(&m_slots[pos & m_mask], t, atomic::MO_RELAXED);
+  }
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<int64_t> m_top;  // Steal index
+  alignas(JNU_CACHE_LINE_SZ) atomic::Base<int64_t> m_bottom;  // Owner index
+  // Read only after construction
+  alignas(JNU_CACHE_LINE_SZ) Slots m_slots;  // Deque slots
+  size_t m_mask;  // Index mask
+};
+}
+
+#endif
@@ -0,0 +1,368 @@
+// By JNI
+// Implementation of intrusive reference counting
+// The reference count is buried inside of target objects,
+// objects are released through the memory manager
+// used to create them, therefore no extra control block
+// is allocated
+// Biased mode is provided for objects mostly referenced
+// by the thread creating them: references held by the
+// owner thread are counted without atomic operations
+
+#ifndef JNU_REF_H
+#define JNU_REF_H
+
+#include <assert.h>
+#include <utility>
+#include "jnu_atomic.h"
+#include "jnu_memory.h"
+
+namespace jnu {
+template<typename T> class Ref;
+template<typename T> class LocalRef;
+// Base of reference counted objects
+// Template argument: B - biased mode
+template<bool B = false>
+class RefCountedT;
+// Reference count with single atomic counter
+template<>
+class RefCountedT<false> {
+  template<typename T> friend class Ref;
+public:
+  // Get current reference count (snapshot)
+  uint32_t RefCount() const {
+    return m_count.Load();
+  }
+  // Get memory manager used to create the object
+  memory::MMBase* GetMM() const {
+    return m_mm;
+  }
+protected:
+  // Constructor, no reference at beginning
+  RefCountedT()
+    : m_count (0),
+      m_mm (NULL) {
+  }
+  // Copy constructor, reference count is not copied
+  RefCountedT(const RefCountedT& r)
+    : RefCountedT () {
+  }
+  // Assign operator, reference count is not copied
+  RefCountedT& operator=(const RefCountedT& r) {
+    return *this;
+  }
+  // Deconstructor
+  ~RefCountedT() {
+  }
+private:
+  // Add one reference (relaxed)
+  void AddRef() {
+    m_count.FetchAdd(1, atomic::MO_RELAXED);
+  }
+  // Remove one reference
+  // Return: true - the last reference is removed
+  bool Release() {
+    return m_count.SubFetch(1, atomic::MO_ACQ_REL) == 0;
+  }
+  atomic::Base<uint32_t> m_count;  // Reference count
+  memory::MMBase* m_mm;  // Memory manager
+};
+// Biased reference count
+// References held by the owner thread (LocalRef) are
+// counted by a plain integer, the others (Ref) are
+// counted by an atomic side counter
+// The side counter stores (count << 1 | flag), the flag
+// is set when the owner holds no local references, so
+// whichever side drops the last reference releases
+// the object
+template<>
+class RefCountedT<true> {
+  template<typename T> friend class Ref;
+  template<typename T> friend class LocalRef;
+  static constexpr uint32_t MERGED = 1;  // No local references flag
+  static constexpr uint32_t ONE = 2;  // One shared reference
+public:
+  // Get current reference count (snapshot)
+  // It is only accurate on the owner thread
+  uint32_t RefCount() const {
+    return m_local + (m_shared.Load() >> 1);
+  }
+  // Get memory manager used to create the object
+  memory::MMBase* GetMM() const {
+    return m_mm;
+  }
+  // Check if the calling thread is the owner
+  bool IsOwner() const {
+    return m_owner == Token();
+  }
+protected:
+  // Constructor, the constructing thread is the owner
+  RefCountedT()
+    : m_local (0),
+      m_shared (MERGED),
+      m_mm (NULL),
+      m_owner (Token()) {
+  }
+  // Copy constructor, reference count is not copied
+  RefCountedT(const RefCountedT& r)
+    : RefCountedT () {
+  }
+  // Assign operator, reference count is not copied
+  RefCountedT& operator=(const RefCountedT& r) {
+    return *this;
+  }
+  // Deconstructor
+  ~RefCountedT() {
+  }
+private:
+  // Token of the calling thread
+  static const void* Token() {
+    static thread_local char token;
+    return &token;
+  }
+  // Add one shared reference (relaxed)
+  void AddRef() {
+    m_shared.FetchAdd(ONE, atomic::MO_RELAXED);
+  }
+  // Remove one shared reference
+  // Return: true - the last reference is removed
+  bool Release() {
+    return m_shared.SubFetch(ONE, atomic::MO_ACQ_REL) == MERGED;
+  }
+  // Add one local reference (owner thread only, checked
+  // by assert)
+  // The caller already holds a reference, so the
+  // object cannot be released while clearing the flag
+  void AddLocalRef() {
+    assert(IsOwner());
+    if (m_local++ == 0) {  // First local reference
+      m_shared.FetchAnd(~MERGED, atomic::MO_RELAXED);
+    }
+  }
+  // Remove one local reference (owner thread only, checked
+  // by assert)
+  // Return: true - the last reference is removed
+  bool ReleaseLocal() {
+    assert(IsOwner());
+    if (--m_local == 0) {  // Last local reference
+      return m_shared.FetchOr(MERGED, atomic::MO_ACQ_REL) == 0;
+    }
+    return false;
+  }
+  uint32_t m_local;  // Local reference count
+  atomic::Base<uint32_t> m_shared;  // Shared reference count
+  memory::MMBase* m_mm;  // Memory manager
+  const void* m_owner;  // Owner thread token
+};
+// Define of reference counted bases
+typedef RefCountedT<false> RefCounted;
+typedef RefCountedT<true> BiasedRefCounted;
+// Reference handle of reference counted object
+// It can be copied and released on any threads
+// Template argument: T - object type, inherits RefCounted
+//                        or BiasedRefCounted
+template<typename T>
+class Ref {
+  friend class LocalRef<T>;
+public:
+  typedef T Type;  // Object type
+  // Default constructor
+  Ref()
+    : m_ptr (NULL) {
+  }
+  // Constructor, add reference to object
+  explicit Ref(T* ptr)
+    : m_ptr (ptr) {
+    if (m_ptr) {
+      m_ptr->AddRef();
+    }
+  }
+  // Deconstructor
+  ~Ref() {
+    Reset();
+  }
+  // Copy constructor
+  Ref(const Ref& r)
+    : Ref (r.m_ptr) {
+  }
+  // Move constructor
+  Ref(Ref&& r)
+    : m_ptr (r.m_ptr) {
+    r.m_ptr = NULL;
+  }
+  // Assign operator
+  Ref& operator=(const Ref& r) {
+    if (m_ptr != r.m_ptr) {
+      Ref t(r);  // Add reference first
+      Swap(t);
+    }
+    return *this;
+  }
+  // Move operator
+  Ref& operator=(Ref&& r) {
+    if (this != &r) {
+      Reset();
+      Swap(r);
+    }
+    return *this;
+  }
+  // Create object through memory manager
+  // template arguments A: for construct object of T
+  // Input: mm - memory manage interface
+  //        al - memory alignment
+  //        arg - T's constructor arguments
+  template<typename... A>
+  bool New(memory::MMBase* mm, const memory::Align& al, A... arg) {
+    void* ptr = mm ? mm->Malloc(al, sizeof(T)) : NULL;
+    if (ptr) {  // Allocate success
+      T* t = ::new (ptr) T(arg...);  // New object
+      t->m_mm = mm;  // Remember memory manager for release
+      *this = Ref(t);
+      return true;
+    }
+    return false;  // Fail
+  }
+  // Release reference
+  // The object is destroyed and freed when the last
+  // reference is released
+  // Objects not created by New are not freed
+  void Reset() {
+    if (m_ptr && m_ptr->Release()) {
+      Destroy(m_ptr);
+    }
+    m_ptr = NULL;
+  }
+  // Swap with another handle
+  void Swap(Ref& r) {
+    std::swap(m_ptr, r.m_ptr);
+  }
+  // Bool operator, check if object is valid
+  operator bool() const {
+    return m_ptr != NULL;
+  }
+  // Access object
+  T* Get() const {
+    return m_ptr;
+  }
+  T* operator->() const {
+    return m_ptr;
+  }
+  T& operator*() const {
+    return *m_ptr;
+  }
+  // Equal operator
+  bool operator==(const Ref& r) const {
+    return m_ptr == r.m_ptr;
+  }
+  // Not equal operator
+  bool operator!=(const Ref& r) const {
+    return m_ptr != r.m_ptr;
+  }
+private:
+  // Destroy object and free memory
+  static void Destroy(T* t) {
+    if (memory::MMBase* mm = t->GetMM()) {
+      t->~T();
+      mm->Free(t);
+    }
+  }
+  T* m_ptr;  // Object pointer
+};
+// Local reference handle of biased reference counted object
+// Copying and releasing it does not use atomic operations,
+// it must only be used on the owner thread of the object
+// Convert it to Ref before handing the object to others
+// Template argument: T - object type, inherits BiasedRefCounted
+template<typename T>
+class LocalRef {
+public:
+  typedef T Type;  // Object type
+  // Default constructor
+  LocalRef()
+    : m_ptr (NULL) {
+  }
+  // Constructor from shared reference
+  explicit LocalRef(const Ref<T>& r)
+    : LocalRef (r.Get(), true) {
+  }
+  // Deconstructor
+  ~LocalRef() {
+    Reset();
+  }
+  // Copy constructor
+  LocalRef(const LocalRef& r)
+    : LocalRef (r.m_ptr, true) {
+  }
+  // Move constructor
+  LocalRef(LocalRef&& r)
+    : m_ptr (r.m_ptr) {
+    r.m_ptr = NULL;
+  }
+  // Assign operator
+  LocalRef& operator=(const LocalRef& r) {
+    if (m_ptr != r.m_ptr) {
+      LocalRef t(r);  // Add reference first
+      Swap(t);
+    }
+    return *this;
+  }
+  // Move operator
+  LocalRef& operator=(LocalRef&& r) {
+    if (this != &r) {
+      Reset();
+      Swap(r);
+    }
+    return *this;
+  }
+  // Create object through memory manager
+  // The calling thread becomes the owner
+  template<typename... A>
+  bool New(memory::MMBase* mm, const memory::Align& al, A... arg) {
+    Ref<T> r;
+    if (r.New(mm, al, arg...)) {
+      *this = LocalRef(r);
+      return true;
+    }
+    return false;
+  }
+  // Convert to shared reference
+  Ref<T> Share() const {
+    return Ref<T>(m_ptr);
+  }
+  // Release reference
+  void Reset() {
+    if (m_ptr && m_ptr->ReleaseLocal()) {
+      Ref<T>::Destroy(m_ptr);
+    }
+    m_ptr = NULL;
+  }
+  // Swap with another handle
+  void Swap(LocalRef& r) {
+    std::swap(m_ptr, r.m_ptr);
+  }
+  // Bool operator, check if object is valid
+  operator bool() const {
+    return m_ptr != NULL;
+  }
+  // Access object
+  T* Get() const {
+    return m_ptr;
+  }
+  T* operator->() const {
+    return m_ptr;
+  }
+  T& operator*() const {
+    return *m_ptr;
+  }
+private:
+  // Constructor, add local reference
+  LocalRef(T* ptr, bool add)
+    : m_ptr (ptr) {
+    if (m_ptr) {
+      m_ptr->AddLocalRef();
+    }
+  }
+  T* m_ptr;  // Object pointer
+};
+}
+
+#endif
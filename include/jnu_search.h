@@ -0,0 +1,151 @@
+// By JNI
+// Search helpers on sorted arrays of arithmetic keys
+// Lower bound is done by a branchless binary search (the
+// range start is updated by conditional move) down to a
+// small window, the window is finished by counting keys
+// less than the searched key, which is vectorized (SSE2 or
+// AVX2) for plain arrays of 32 bit integers and floating
+// points, and scalar without SSE2
+
+#ifndef JNU_SEARCH_H
+#define JNU_SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace jnu {
+namespace search {
+const static size_t SCAN_WINDOW = 16;  // Keys finished by scan
+// Count keys less than key in small array (scalar)
+// Input: s, n - the array
+//        key - searched key
+//        key_of - function getting key of element
+template<typename T, typename K, typename F>
+size_t CountLess(const T* s, size_t n, const K& key, F key_of) {
+  size_t c = 0;  // Number of less keys
+  for (size_t i = 0; i < n; ++i) {
+    c += key_of(s[i]) < key;
+  }
+  return c;
+}
+// Count keys less than key in plain array (scalar)
+template<typename K>
+size_t CountLess(const K* s, size_t n, const K& key) {
+  size_t c = 0;  // Number of less keys
+  for (size_t i = 0; i < n; ++i) {
+    c += s[i] < key;
+  }
+  return c;
+}
+#ifdef __SSE2__
+// Count signed 32 bit keys less than key (SIMD)
+static inline size_t CountLess(const int32_t* s, size_t n,
+                               const int32_t& key) {
+  size_t c = 0;  // Number of less keys
+  size_t i = 0;  // Scan position
+#ifdef __AVX2__
+  __m256i k8 = _mm256_set1_epi32(key);
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) (s + i));
+    __m256 lt = _mm256_castsi256_ps(_mm256_cmpgt_epi32(k8, v));
+    c += __builtin_popcount(_mm256_movemask_ps(lt));
+  }
+#endif
+  __m128i k4 = _mm_set1_epi32(key);
+  for (; i + 4 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i*) (s + i));
+    __m128 lt = _mm_castsi128_ps(_mm_cmplt_epi32(v, k4));
+    c += __builtin_popcount(_mm_movemask_ps(lt));
+  }
+  return c + CountLess<int32_t>(s + i, n - i, key);
+}
+// Count unsigned 32 bit keys less than key (SIMD)
+// Signed comparison on keys with sign bit flipped
+static inline size_t CountLess(const uint32_t* s, size_t n,
+                               const uint32_t& key) {
+  const static uint32_t SIGN = 0x80000000;  // Sign bit
+  size_t c = 0;  // Number of less keys
+  size_t i = 0;  // Scan position
+  __m128i sign = _mm_set1_epi32(SIGN);
+  __m128i k4 = _mm_set1_epi32(key ^ SIGN);
+  for (; i + 4 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i*) (s + i));
+    v = _mm_xor_si128(v, sign);
+    __m128 lt = _mm_castsi128_ps(_mm_cmplt_epi32(v, k4));
+    c += __builtin_popcount(_mm_movemask_ps(lt));
+  }
+  return c + CountLess<uint32_t>(s + i, n - i, key);
+}
+// Count single precision keys less than key (SIMD)
+static inline size_t CountLess(const float* s, size_t n,
+                               const float& key) {
+  size_t c = 0;  // Number of less keys
+  size_t i = 0;  // Scan position
+#ifdef __AVX2__
+  __m256 k8 = _mm256_set1_ps(key);
+  for (; i + 8 <= n; i += 8) {
+    __m256 lt = _mm256_cmp_ps(_mm256_loadu_ps(s + i), k8, _CMP_LT_OQ);
+    c += __builtin_popcount(_mm256_movemask_ps(lt));
+  }
+#endif
+  __m128 k4 = _mm_set1_ps(key);
+  for (; i + 4 <= n; i += 4) {
+    __m128 lt = _mm_cmplt_ps(_mm_loadu_ps(s + i), k4);
+    c += __builtin_popcount(_mm_movemask_ps(lt));
+  }
+  return c + CountLess<float>(s + i, n - i, key);
+}
+// Count double precision keys less than key (SIMD)
+static inline size_t CountLess(const double* s, size_t n,
+                               const double& key) {
+  size_t c = 0;  // Number of less keys
+  size_t i = 0;  // Scan position
+  __m128d k2 = _mm_set1_pd(key);
+  for (; i + 2 <= n; i += 2) {
+    __m128d lt = _mm_cmplt_pd(_mm_loadu_pd(s + i), k2);
+    c += __builtin_popcount(_mm_movemask_pd(lt));
+  }
+  return c + CountLess<double>(s + i, n - i, key);
+}
+#endif
+// Branchless lower bound
+// Input: s, e - sorted range
+//        key - searched key
+//        key_of - function getting key of element
+// Return: first element whose key is not less than key
+template<typename T, typename K, typename F>
+T* LowerBound(T* s, T* e, const K& key, F key_of) {
+  size_t n = e - s;  // Range size
+  while (n > SCAN_WINDOW) {  // Lower bound in [s, s + n]
+    size_t half = n / 2;
+    __builtin_prefetch(s + half / 2);  // Both next middles
+    __builtin_prefetch(s + half + half / 2);
+    s = key_of(s[half - 1]) < key ? s + half : s;  // Conditional move
+    n -= half;
+  }
+  return s + CountLess(s, n, key, key_of);
+}
+// Branchless lower bound of plain key array
+// Window is finished by SIMD scan for supported key types
+template<typename K>
+K* LowerBound(K* s, K* e, const K& key) {
+  size_t n = e - s;  // Range size
+  while (n > SCAN_WINDOW) {  // Lower bound in [s, s + n]
+    size_t half = n / 2;
+    __builtin_prefetch(s + half / 2);  // Both next middles
+    __builtin_prefetch(s + half + half / 2);
+    s = s[half - 1] < key ? s + half : s;  // Conditional move
+    n -= half;
+  }
+  return s + CountLess((const K*) s, n, key);
+}
+}
+}
+
+#endif
@@ -0,0 +1,83 @@
+// By JNI
+// Base of companion search indexes of sorted set
+// A companion index is built from a sorted set (ArraySetT), it
+// answers searches of the set, while the set keeps elements
+// The set size and data of the last build are remembered, so a
+// set moved or resized since is detected as stale, content
+// changes of same size are not, so positions found by an index
+// are validated against the set, an index which is stale or
+// fails validation falls back to the search of the set
+
+#ifndef JNU_SET_INDEX_H
+#define JNU_SET_INDEX_H
+
+#include "jnu_defines.h"
+#include "jnu_array_set.h"
+
+namespace jnu {
+// Companion index base
+// Template arguments:
+// S - sorted set type (ArraySetT)
+template<typename S>
+class SetIndex {
+  typedef typename S::Type T;  // Element type
+  typedef typename S::Key K;  // Key type
+  typedef typename S::Res Res;  // Search result
+public:
+  typedef T Type;  // Element type
+  typedef K Key;  // Key type
+  const static size_t NPOS = (size_t) (-1);  // No position
+  // Get indexed set, for ordered iteration and ranges
+  const S& Set() const {
+    return m_set;
+  }
+  // Check if set moved or resized since last build
+  bool IsStale() const {
+    return m_sz != m_set.Size() || m_data != m_set.Begin();
+  }
+protected:
+  // Constructor, index is stale until built
+  // Input: set - the indexed set
+  explicit SetIndex(const S& set)
+    : m_set (set),
+      m_sz (0),
+      m_data (NULL) {
+  }
+  // Remember the set of a completed build
+  void Built() {
+    m_sz = m_set.Size();
+    m_data = m_set.Begin();
+  }
+  // Drop the set of last build, before a build
+  void Unbuilt() {
+    m_sz = 0;
+    m_data = NULL;
+  }
+  // Check if index can be searched, set is not empty and
+  // not stale
+  bool IsUsable() const {
+    return m_sz && !IsStale();
+  }
+  // Validate position found by index
+  // Input: key - search key
+  //        p - lower bound of key found by index, NPOS if
+  //            index is not usable
+  // Return: location of key at p if p is the lower bound,
+  //         otherwise the location searched in set
+  Res Validate(const K& key, size_t p) const {
+    size_t n = m_set.Size();  // Number of elements
+    T* d = m_set.Begin();  // Sorted elements
+    if (p <= n && (!p || S::KeyLess(S::KeyOf(d[p - 1]), key)) &&
+        (p == n || !S::KeyLess(S::KeyOf(d[p]), key))) {
+      return Res(d + p, p < n && !S::KeyLess(key, S::KeyOf(d[p])));
+    }
+    return m_set.Locate(key);  // Stale index, search the set
+  }
+  const S& m_set;  // Indexed set
+private:
+  size_t m_sz;  // Set size of last build
+  const T* m_data;  // Set data of last build
+};
+}
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <ctype.h>
 #include <string>
+#include <type_traits>
 #include "jnu_array.h"
 
 namespace jnu {
@@ -299,6 +300,70 @@ private:
   size_t m_size;
 };
 template<typename H>
+class StringImp;
+// Check if T is a string type of library or std, which is
+// compared with StringView by the operators below
+template<typename T>
+struct IsString : std::false_type {
+};
+template<>
+struct IsString<std::string> : std::true_type {
+};
+template<>
+struct IsString<const char*> : std::true_type {
+};
+template<>
+struct IsString<char*> : std::true_type {
+};
+template<size_t N>
+struct IsString<char[N]> : std::true_type {
+};
+template<typename H>
+struct IsString<StringImp<H>> : std::true_type {
+};
+// Compare string s with view v, the reverse of StringView
+// operators, so a string may be on either side
+template<typename T, typename = typename std::enable_if<
+                       IsString<T>::value>::type>
+bool operator==(const T& s, const StringView& v) {
+  return v == s;
+}
+template<typename T, typename = typename std::enable_if<
+                       IsString<T>::value>::type>
+bool operator!=(const T& s, const StringView& v) {
+  return v != s;
+}
+// Lexicographic order, as StringView::operator<
+template<typename T, typename = typename std::enable_if<
+                       IsString<T>::value>::type>
+bool operator<(const T& s, const StringView& v) {
+  return v > s;
+}
+template<typename T, typename = typename std::enable_if<
+                       IsString<T>::value>::type>
+bool operator>(const T& s, const StringView& v) {
+  return v < s;
+}
+// Lexicographic less of any two strings, a transparent
+// comparator object, strings are compared through StringView
+// without conversion to a key type
+struct StringLess {
+  template<typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    return StringView(a).CompareA(b) < 0;
+  }
+};
+// Case insensitive lexicographic less of any two strings
+struct StringLessCase {
+  template<typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    return StringView(a).CompareACase(b) < 0;
+  }
+};
+// Comparator objects, as LESS of sorted set (&STRING_LESS)
+inline constexpr StringLess STRING_LESS = {};
+inline constexpr StringLessCase STRING_LESS_CASE = {};
+template<typename H>
 class StringImp {
 public:
   static constexpr char TERM = StringView::TERM;
@@ -0,0 +1,156 @@
+// By JNI
+// Work stealing thread pool
+// Each worker owns a Chase-Lev deque, tasks submitted by a
+// worker go to its own deque, tasks submitted by other
+// threads go to a shared injection queue
+// Idle workers steal from random victims and finally park
+// on a futex until new tasks are submitted
+// Tasks are constructed in pre-allocated slots, so submitting
+// a task never allocates
+
+#ifndef JNU_THREAD_POOL_H
+#define JNU_THREAD_POOL_H
+
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include "jnu_defines.h"
+#include "jnu_atomic.h"
+#include "jnu_memory.h"
+#include "jnu_bitset.h"
+#include "jnu_callback.h"
+#include "jnu_queue.h"
+
+namespace jnu {
+// Work stealing thread pool
+class ThreadPool {
+public:
+  static constexpr size_t NPOS = (size_t) (-1);  // Not a worker
+  // Group of tasks, used for waiting tasks to complete
+  class Group {
+    friend class ThreadPool;
+  public:
+    // Constructor
+    Group()
+      : m_pending (0) {
+    }
+    // Keep unique, no copy constructor allowed
+    Group(const Group& g) = delete;
+    // Keep unique, no assign operator allowed
+    Group& operator=(const Group& g) = delete;
+    // Check if all tasks of group are completed
+    bool IsDone() const {
+      return m_pending.Load(atomic::MO_ACQUIRE) == 0;
+    }
+  private:
+    atomic::Base<size_t> m_pending;  // Number of pending tasks
+  };
+  // Constructor
+  // Input: threads - number of workers (0 for number of cores)
+  //        sz - maximum number of pending tasks
+  //        mm - memory manager
+  ThreadPool(size_t threads = 0, size_t sz = 1024,
+             memory::MMBase* mm = &memory::MM_BUILDIN);
+  // Deconstructor
+  // Pending tasks are completed before workers exit
+  ~ThreadPool();
+  // Keep unique, no copy constructor allowed
+  ThreadPool(const ThreadPool& p) = delete;
+  // Keep unique, no assign operator allowed
+  ThreadPool& operator=(const ThreadPool& p) = delete;
+  // Number of workers
+  size_t Size() const {
+    return m_workers.Size();
+  }
+  // Maximum number of pending tasks
+  size_t Capacity() const {
+    return m_jobs.Size();
+  }
+  // Submit task
+  // If all task slots are used, task runs in calling thread
+  // Input: f - callable without arguments (functor, lambda,
+  //            Callback, FuncArg, FuncObj ...)
+  template<typename F>
+  void Submit(F&& f) {
+    Post(NULL, std::forward<F>(f));
+  }
+  // Submit task of group
+  template<typename F>
+  void Submit(Group& g, F&& f) {
+    Post(&g, std::forward<F>(f));
+  }
+  // Wait for all tasks of group to complete
+  // Calling thread runs pending tasks while waiting
+  void Wait(Group& g);
+  // Run one pending task in calling thread
+  // Return: true - a task is run, false - no task found
+  bool RunOne();
+  // Index of calling thread in workers
+  // Return: worker index, NPOS if not a worker of this pool
+  size_t WorkerIndex() const;
+private:
+  // Task slot
+  struct Job {
+    // Constructor
+    Job(Group* g)
+      : m_group (g) {
+    }
+    Task m_task;  // Task
+    Group* m_group;  // Group of task
+  };
+  // Worker thread
+  struct alignas(JNU_CACHE_LINE_SZ) Worker {
+    // Constructor
+    Worker(size_t sz, memory::MMBase* mm)
+      : m_deque (sz, mm),
+        m_seed (0) {
+    }
+    WorkStealDeque<Job> m_deque;  // Own tasks
+    std::thread m_thread;  // Thread
+    uint64_t m_seed;  // Random seed for stealing
+  };
+  // Put task into a slot and schedule it
+  template<typename F>
+  void Post(Group* g, F&& f) {
+    size_t i = m_slots.Allocate();  // Task slot
+    if (i == DAtomicBitset::NPOS) {  // No free slot, run here
+      f();
+      return;
+    }
+    Job& job = m_jobs.Ptr()[i];
+    job.m_task.Set(std::forward<F>(f));
+    job.m_group = g;
+    if (g) {
+      g->m_pending.AddFetch(1);
+    }
+    Schedule(job);
+  }
+  // Schedule task of slot
+  void Schedule(Job& job);
+  // Run task and release its slot
+  void Run(Job& job);
+  // Find a task (own deque, injection queue, then steal)
+  // Input: self - calling worker, NULL if not a worker
+  Job* Find(Worker* self);
+  // Check if any task is pending
+  bool HasWork() const;
+  // Worker thread main loop
+  void Loop(size_t i);
+  // Park calling worker until tasks are submitted
+  void Park();
+  // Wake parked workers
+  // Input: n - maximum number of workers to wake
+  void Wake(int n);
+  memory::Obj<Job> m_jobs;  // Task slots
+  DAtomicBitset m_slots;  // Allocation of task slots
+  MpmcQueue<Job*, ARR_MEM_ALLOC> m_inject;  // Tasks from non-workers
+  memory::Obj<Worker> m_workers;  // Workers
+  // Parking state, shared by all workers
+  alignas(JNU_CACHE_LINE_SZ)
+  atomic::Base<uint32_t> m_epoch;  // Futex word
+  atomic::Base<uint32_t> m_sleepers;  // Number of parking workers
+  atomic::Base<bool> m_stop;  // Pool is stopping
+};
+}
+
+#endif
@@ -0,0 +1,195 @@
+// By JNI
+// Implementation of work stealing thread pool
+
+#include "jnu_thread_pool.h"
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+using namespace jnu;
+
+namespace {
+// Spins (yield) before an idle worker parks
+const static size_t IDLE_SPINS = 64;
+// Pool and index of calling worker thread
+thread_local const ThreadPool* t_pool = NULL;
+thread_local size_t t_index = ThreadPool::NPOS;
+// Random seed of threads other than workers
+thread_local uint64_t t_seed = 0;
+// Futex word is the value of atomic, the only member of it
+static_assert(sizeof(atomic::Base<uint32_t>) == sizeof(uint32_t),
+              "Atomic is not a futex word");
+// Wait on futex word while it equals to val
+void FutexWait(atomic::Base<uint32_t>& word, uint32_t val) {
+  syscall(SYS_futex, (uint32_t*) &word, FUTEX_WAIT_PRIVATE, val,
+          NULL, NULL, 0);
+}
+// Wake up to n waiters of futex word
+void FutexWake(atomic::Base<uint32_t>& word, int n) {
+  syscall(SYS_futex, (uint32_t*) &word, FUTEX_WAKE_PRIVATE, n,
+          NULL, NULL, 0);
+}
+// Xorshift random number
+uint64_t Random(uint64_t& seed) {
+  if (!seed) {  // Seed from address of seed (per thread)
+    seed = (uint64_t) &seed | 1;
+  }
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return seed;
+}
+}
+
+// Constructor
+ThreadPool::ThreadPool(size_t threads, size_t sz, memory::MMBase* mm)
+  : m_jobs (mm),
+    m_slots (sz, mm),
+    m_inject (sz, mm),
+    m_workers (mm),
+    m_epoch (0),
+    m_sleepers (0),
+    m_stop (false) {
+  if (!threads) {  // Number of cores
+    threads = JNU_MAX(std::thread::hardware_concurrency(), 1u);
+  }
+  if (!m_jobs.NewArr(JNU_CACHE_LINE_SZ, sz, (Group*) NULL)) {
+    m_slots.Resize(0);  // No slots, tasks run in calling threads
+    return;
+  }
+  if (!m_workers.NewArr(JNU_CACHE_LINE_SZ, threads, sz, mm)) {
+    return;  // No workers, tasks run in calling threads
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    m_workers.Ptr()[i].m_thread = std::thread(&ThreadPool::Loop, this, i);
+  }
+}
+// Deconstructor
+ThreadPool::~ThreadPool() {
+  m_stop.Store(true, atomic::MO_SEQ_CST);
+  Wake(INT_MAX);  // Wake all workers to exit
+  for (size_t i = 0; i < Size(); ++i) {
+    m_workers.Ptr()[i].m_thread.join();
+  }
+}
+// Wait for all tasks of group to complete
+void ThreadPool::Wait(Group& g) {
+  while (!g.IsDone()) {
+    if (!RunOne()) {  // Nothing to help, tasks are running
+      std::this_thread::yield();
+    }
+  }
+}
+// Run one pending task in calling thread
+bool ThreadPool::RunOne() {
+  size_t i = WorkerIndex();  // Calling worker
+  if (Job* job = Find(i == NPOS ? NULL : m_workers.Ptr() + i)) {
+    Run(*job);
+    return true;
+  }
+  return false;
+}
+// Index of calling thread in workers
+size_t ThreadPool::WorkerIndex() const {
+  return t_pool == this ? t_index : NPOS;
+}
+// Schedule task of slot
+void ThreadPool::Schedule(Job& job) {
+  size_t i = WorkerIndex();  // Calling worker
+  // Both deque and injection queue have room for all slots,
+  // run here only if pool has no workers
+  if (!(i != NPOS && m_workers.Ptr()[i].m_deque.Push(&job)) &&
+      !(Size() && m_inject.Push(&job))) {
+    Run(job);
+    return;
+  }
+  Wake(1);
+}
+// Run task and release its slot
+void ThreadPool::Run(Job& job) {
+  Group* g = job.m_group;  // Group of task
+  job.m_task();
+  job.m_task.Reset();  // Destroy before slot is reused
+  job.m_group = NULL;
+  m_slots.Free(&job - m_jobs.Ptr());
+  if (g) {
+    g->m_pending.SubFetch(1, atomic::MO_RELEASE);
+  }
+}
+// Find a task
+ThreadPool::Job* ThreadPool::Find(Worker* self) {
+  if (self) {  // Own deque first, most recent task
+    if (Job* job = self->m_deque.Pop()) {
+      return job;
+    }
+  }
+  Job* job = NULL;
+  if (m_inject.Pop(job)) {  // Tasks of non-workers
+    return job;
+  }
+  size_t n = Size();  // Steal from random victim
+  size_t r = n ? Random(self ? self->m_seed : t_seed) % n : 0;
+  for (size_t k = 0; k < n; ++k) {
+    Worker* w = m_workers.Ptr() + (r + k) % n;  // Victim
+    if (w != self) {
+      if (Job* job = w->m_deque.Steal()) {
+        return job;
+      }
+    }
+  }
+  return NULL;
+}
+// Check if any task is pending
+bool ThreadPool::HasWork() const {
+  if (!m_inject.IsEmpty()) {
+    return true;
+  }
+  for (size_t i = 0; i < Size(); ++i) {
+    if (!m_workers.Ptr()[i].m_deque.IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+// Worker thread main loop
+void ThreadPool::Loop(size_t i) {
+  t_pool = this;  // Identify calling worker
+  t_index = i;
+  Worker* self = m_workers.Ptr() + i;
+  size_t idle = 0;  // Number of failed finds
+  for (;;) {
+    if (Job* job = Find(self)) {
+      Run(*job);
+      idle = 0;
+    } else if (m_stop.Load(atomic::MO_ACQUIRE) &&
+               !HasWork()) {
+      break;  // Exit only when nothing is left
+    } else if (++idle < IDLE_SPINS) {
+      std::this_thread::yield();
+    } else {
+      Park();
+      idle = 0;
+    }
+  }
+}
+// Park calling worker until tasks are submitted
+void ThreadPool::Park() {
+  // Announce parking before the last check, so a submitter
+  // either sees the sleeper and bumps epoch, or the check
+  // sees its task
+  m_sleepers.FetchAdd(1, atomic::MO_SEQ_CST);
+  uint32_t epoch = m_epoch.Load(atomic::MO_SEQ_CST);
+  if (!HasWork() && !m_stop.Load(atomic::MO_SEQ_CST)) {
+    FutexWait(m_epoch, epoch);  // Returns at once if epoch moved
+  }
+  m_sleepers.FetchSub(1, atomic::MO_SEQ_CST);
+}
+// Wake parked workers
+void ThreadPool::Wake(int n) {
+  atomic::ThreadFence(atomic::MO_SEQ_CST);  // Task before sleepers
+  if (m_sleepers.Load(atomic::MO_SEQ_CST)) {
+    m_epoch.FetchAdd(1, atomic::MO_SEQ_CST);
+    FutexWake(m_epoch, n);
+  }
+}
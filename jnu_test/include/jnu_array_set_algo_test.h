@@ -0,0 +1,24 @@
+// By JNI
+// Test of set algebra on array sets
+
+#ifndef JNU_ARRAY_SET_ALGO_TEST_H
+#define JNU_ARRAY_SET_ALGO_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_array_set_algo.h"
+#include <vector>
+
+namespace jnu_test {
+// Set algebra test case
+class ArraySetAlgoTest : public jnu::TestCase {
+  // Compare set operations with standard algorithms
+  // Input: na, nb - set sizes
+  //        base - smallest key
+  template<typename K>
+  void Check(size_t na, size_t nb, K base);
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
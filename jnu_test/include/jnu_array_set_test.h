@@ -6,6 +6,7 @@
 
 #include "jnu_unit_test.h"
 #include "jnu_array_set.h"
+#include "jnu_string.h"
 #include <utility>
 #include <string>
 
@@ -29,6 +30,29 @@ class ArraySetTest : public jnu::TestCase {
     }
     std::string m_str;
   };
+  // Reversed order of strings
+  static bool Greater(const std::string& a, const std::string& b) {
+    return a > b;
+  }
+  // Bulk insert test
+  void TestBulk();
+  // Sorted merge test
+  void TestMerge();
+  // Search of arithmetic keys
+  template<typename K>
+  void CheckSearch(K base, K step);
+  // Branchless search test
+  void TestSearch();
+  // Batch find test
+  void TestFindBatch();
+  // Range query test
+  void TestRange();
+  // Search by other key types test
+  void TestTransparent();
+  // Equal keys test
+  void TestMulti();
+  // Finger search and cursor test
+  void TestFinger();
   // Main test entry
   void Test();
 };
@@ -0,0 +1,40 @@
+// By JNI
+// Test of concurrent containers on link nodes
+
+#ifndef JNU_ATOMIC_LIST_TEST_H
+#define JNU_ATOMIC_LIST_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_atomic_list.h"
+
+namespace jnu_test {
+// Test object
+struct AItem {
+  typedef jnu::SLink<AItem>::Node Node;  // Single link node
+  // Access single link node
+  Node& GetNode() {
+    return m_node;
+  }
+  Node m_node;  // Single link node
+  int m_val;  // Value
+};
+// Test of lock-free stack
+class AtomicStackTest : public jnu::TestCase {
+  typedef jnu::AtomicStack<AItem, &AItem::GetNode> Stack;
+  // Main test entry
+  void Test();
+};
+// Test of multiple producers single consumer queue
+class MpscQueueTest : public jnu::TestCase {
+  typedef jnu::MpscQueue<AItem, &AItem::GetNode> Queue;
+  // Main test entry
+  void Test();
+};
+// Test of concurrent containers
+class AtomicListTest : public jnu::TestCase {
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,24 @@
+// By JNI
+// Test of atomic wraps
+
+#ifndef JNU_ATOMIC_TEST_H
+#define JNU_ATOMIC_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_atomic.h"
+
+namespace jnu_test {
+// Atomic test case
+class AtomicTest : public jnu::TestCase {
+  // Test of integer operations
+  void TestInteger();
+  // Test of floating point operations
+  void TestFloat();
+  // Test of concurrent updates
+  void TestConcurrent();
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,22 @@
+// By JNI
+// Test of atomic bitset
+
+#ifndef JNU_BITSET_TEST_H
+#define JNU_BITSET_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_bitset.h"
+
+namespace jnu_test {
+// Atomic bitset test case
+class BitsetTest : public jnu::TestCase {
+  // Test of single thread allocation
+  void TestAllocate();
+  // Test of concurrent allocation
+  void TestConcurrent();
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,27 @@
+// By JNI
+// Test of blocked Bloom filter
+
+#ifndef JNU_BLOOM_TEST_H
+#define JNU_BLOOM_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_bloom.h"
+#include "jnu_array_set.h"
+#include "jnu_lsm_array_set.h"
+#include <string>
+
+namespace jnu_test {
+// Bloom filter test case
+class BloomTest : public jnu::TestCase {
+  typedef bool (*Less)(const int&, const int&);  // Default less
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr> ISet;  // Integer set
+  // Log-structured set with filters of levels
+  typedef jnu::LsmArraySet<IArr, (Less) NULL, 16,
+                           jnu::BloomFilter<int>> LSet;
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
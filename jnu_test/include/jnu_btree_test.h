@@ -0,0 +1,31 @@
+// By JNI
+// Test of B+tree sorted set
+
+#ifndef JNU_BTREE_TEST_H
+#define JNU_BTREE_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_btree.h"
+#include <string>
+
+namespace jnu_test {
+// B+tree test case
+class BTreeTest : public jnu::TestCase {
+  typedef bool (*Less)(const int&, const int&);  // Default less
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 8> IArr;
+  // Small nodes, for deep trees
+  typedef jnu::BTreeSet<IArr, (Less) NULL, 4> SmallSet;
+  typedef jnu::BTreeSetT<IArr, int, (const int& (*) (const int)) NULL,
+                         (Less) NULL, 4, 4> TinySet;
+  typedef jnu::BTreeSet<IArr> ISet;  // Default nodes
+  typedef jnu::DArrayPair<std::string, int, jnu::ARR_OBJ_ALLOC, 8> SArr;
+  typedef jnu::BTreeMap<SArr> SMap;  // String map
+  // Random inserts and deletes compared with reference
+  template<typename S>
+  void Check(int n);
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
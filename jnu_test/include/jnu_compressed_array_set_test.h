@@ -0,0 +1,24 @@
+// By JNI
+// Test of compressed sorted set
+
+#ifndef JNU_COMPRESSED_ARRAY_SET_TEST_H
+#define JNU_COMPRESSED_ARRAY_SET_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_compressed_array_set.h"
+
+namespace jnu_test {
+// Compressed sorted set test case
+class CompressedArraySetTest : public jnu::TestCase {
+  // Compare set with its elements for keys in and between
+  // elements, iteration and lower bounds
+  // Input: n - set size
+  //        key - function generating element i (increasing)
+  template<typename T, typename F>
+  void Check(size_t n, F key);
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,23 @@
+// By JNI
+// Test of Eytzinger layout search index
+
+#ifndef JNU_EYTZINGER_TEST_H
+#define JNU_EYTZINGER_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_eytzinger.h"
+#include <string>
+
+namespace jnu_test {
+// Eytzinger index test case
+class EytzingerTest : public jnu::TestCase {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr> ISet;  // Integer set
+  typedef jnu::DArrayPair<std::string, int, jnu::ARR_OBJ_ALLOC, 8> SArr;
+  typedef jnu::ArrayMap<SArr> SMap;  // Map of string keys
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,31 @@
+// By JNI
+// Test of perfect hash index
+
+#ifndef JNU_FROZEN_MAP_TEST_H
+#define JNU_FROZEN_MAP_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_frozen_map.h"
+#include <string>
+
+namespace jnu_test {
+// Perfect hash index test case
+class FrozenMapTest : public jnu::TestCase {
+  typedef jnu::DArrayPair<long, std::string, jnu::ARR_OBJ_ALLOC, 8> LArr;
+  typedef jnu::ArrayMap<LArr> LMap;  // Map of integral keys
+  typedef jnu::DArrayPair<std::string, int, jnu::ARR_OBJ_ALLOC, 8> SArr;
+  typedef jnu::ArrayMap<SArr> SMap;  // Map of string keys
+  // Hash function with all keys equal
+  struct BadHash {
+    size_t operator()(long key) const {
+      return 7;
+    }
+  };
+  // Freeze maps of n keys and compare lookups with map
+  void Check(size_t n);
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,28 @@
+// By JNI
+// Test of log-structured sorted set
+
+#ifndef JNU_LSM_ARRAY_SET_TEST_H
+#define JNU_LSM_ARRAY_SET_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_lsm_array_set.h"
+#include "jnu_bloom.h"
+#include <string>
+
+namespace jnu_test {
+// Log-structured set test case
+class LsmArraySetTest : public jnu::TestCase {
+  typedef bool (*Less)(const int&, const int&);  // Default less
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::LsmArraySet<IArr, (Less) NULL, 8> ISet;  // Integer set
+  typedef jnu::DArrayPair<int, std::string, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  typedef jnu::LsmArrayMap<PArr, (Less) NULL, 4> PMap;  // String map
+  // Set of levels filtered by Bloom filters
+  typedef jnu::LsmArraySet<IArr, (Less) NULL, 8,
+                           jnu::BloomFilter<int>> BSet;
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
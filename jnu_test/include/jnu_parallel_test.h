@@ -0,0 +1,20 @@
+// By JNI
+// Test of parallel algorithms
+
+#ifndef JNU_PARALLEL_TEST_H
+#define JNU_PARALLEL_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_parallel.h"
+
+namespace jnu_test {
+// Parallel algorithms test case
+class ParallelTest : public jnu::TestCase {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> Arr;
+  typedef jnu::HArray<long, 16, jnu::ARR_MEM_ALLOC, 64> LArr;
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,26 @@
+// By JNI
+// Test of learned search index
+
+#ifndef JNU_PGM_TEST_H
+#define JNU_PGM_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_pgm.h"
+#include <string>
+
+namespace jnu_test {
+// Learned index test case
+class PgmTest : public jnu::TestCase {
+  typedef jnu::DArrayPair<long, std::string, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  typedef jnu::ArrayMap<PArr> PMap;  // Map of integral keys
+  // Compare index with set for keys in and between elements
+  // Input: n - set size
+  //        key - function generating key i (increasing)
+  template<typename K, size_t EPS, typename F>
+  void Check(size_t n, F key);
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
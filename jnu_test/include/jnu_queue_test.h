@@ -0,0 +1,39 @@
+// By JNI
+// Test of bounded concurrent queues
+
+#ifndef JNU_QUEUE_TEST_H
+#define JNU_QUEUE_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_queue.h"
+#include <string>
+
+namespace jnu_test {
+// Test of single producer single consumer ring
+class SpscRingTest : public jnu::TestCase {
+  typedef jnu::SpscRing<int, 8, jnu::ARR_MEM_ALLOC> Ring;
+  typedef jnu::DSpscRing<std::string, jnu::ARR_OBJ_ALLOC> SRing;
+  // Main test entry
+  void Test();
+};
+// Test of multiple producers multiple consumers queue
+class MpmcQueueTest : public jnu::TestCase {
+  typedef jnu::MpmcQueue<int, jnu::ARR_MEM_ALLOC> Queue;
+  typedef jnu::MpmcQueue<std::string, jnu::ARR_OBJ_ALLOC> SQueue;
+  // Main test entry
+  void Test();
+};
+// Test of work stealing deque
+class WorkStealDequeTest : public jnu::TestCase {
+  typedef jnu::WorkStealDeque<int> Deque;
+  // Main test entry
+  void Test();
+};
+// Test of bounded queues
+class QueueTest : public jnu::TestCase {
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
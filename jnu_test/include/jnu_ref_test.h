@@ -0,0 +1,22 @@
+// By JNI
+// Test of intrusive reference counting
+
+#ifndef JNU_REF_TEST_H
+#define JNU_REF_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_ref.h"
+
+namespace jnu_test {
+// Reference counting test case
+class RefTest : public jnu::TestCase {
+  // Test of atomic reference count
+  void TestRef();
+  // Test of biased reference count
+  void TestBiased();
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,18 @@
+// By JNI
+// Test of work stealing thread pool
+
+#ifndef JNU_THREAD_POOL_TEST_H
+#define JNU_THREAD_POOL_TEST_H
+
+#include "jnu_unit_test.h"
+#include "jnu_thread_pool.h"
+
+namespace jnu_test {
+// Thread pool test case
+class ThreadPoolTest : public jnu::TestCase {
+  // Main test entry
+  void Test();
+};
+}
+
+#endif
@@ -0,0 +1,96 @@
+// By JNI
+// Implementation of set algebra tests
+
+#include "jnu_array_set_algo_test.h"
+#include <stdint.h>
+#include <string>
+#include <algorithm>
+#include <iterator>
+
+using namespace jnu_test;
+
+// Compare set operations with standard algorithms
+template<typename K>
+void ArraySetAlgoTest::Check(size_t na, size_t nb, K base) {
+  typedef jnu::DArray<K, jnu::ARR_MEM_ALLOC, 64> KArr;
+  typedef jnu::ArraySet<KArr> KSet;
+  KSet a;
+  KSet b;
+  unsigned int seed = na * 31 + nb;  // Random keys in small range,
+  size_t range = (na + nb) * 2;      // so sets overlap
+  for (size_t i = 0; i < na; ++i) {
+    a.Insert(base + (K) (rand_r(&seed) % range));
+  }
+  for (size_t i = 0; i < nb; ++i) {
+    b.Insert(base + (K) (rand_r(&seed) % range));
+  }
+  std::vector<K> ref;  // Reference result
+  std::vector<K> res;  // Result of callback
+  auto push = [&res](const K& k) { res.push_back(k); };
+  KSet out;  // Result of set
+  auto same = [&]() {  // Results of callback and set
+    JNU_UT_CHECK(res == ref);
+    JNU_UT_EQUAL(out.Size(), ref.size());
+    JNU_UT_CHECK(out.Size() == ref.size() &&
+                 std::equal(ref.begin(), ref.end(), out.Begin()));
+  };
+  std::set_union(a.Begin(), a.End(), b.Begin(), b.End(),
+                 std::back_inserter(ref));
+  JNU_UT_EQUAL(jnu::algo::Union(a, b, push), ref.size());
+  JNU_UT_CHECK(jnu::algo::Union(a, b, out));
+  same();
+  ref.clear();
+  res.clear();
+  std::set_intersection(a.Begin(), a.End(), b.Begin(), b.End(),
+                        std::back_inserter(ref));
+  JNU_UT_EQUAL(jnu::algo::Intersect(a, b, push), ref.size());
+  JNU_UT_CHECK(jnu::algo::Intersect(a, b, out));
+  same();
+  ref.clear();
+  res.clear();
+  std::set_difference(a.Begin(), a.End(), b.Begin(), b.End(),
+                      std::back_inserter(ref));
+  JNU_UT_EQUAL(jnu::algo::Difference(a, b, push), ref.size());
+  JNU_UT_CHECK(jnu::algo::Difference(a, b, out));
+  same();
+  ref.clear();
+  res.clear();
+  std::set_symmetric_difference(a.Begin(), a.End(), b.Begin(), b.End(),
+                                std::back_inserter(ref));
+  JNU_UT_EQUAL(jnu::algo::SymmetricDifference(a, b, push), ref.size());
+  JNU_UT_CHECK(jnu::algo::SymmetricDifference(a, b, out));
+  same();
+}
+// Main test entry
+void ArraySetAlgoTest::Test() {
+  // Similar sizes (blocks for integers) and very different
+  // sizes (galloping), with empty sets
+  const size_t sizes[][2] = {{0, 0}, {0, 10}, {10, 0}, {3, 5},
+                             {100, 120}, {1000, 900}, {7, 2000},
+                             {3000, 20}, {1, 500}};
+  for (auto& sz : sizes) {
+    Check<uint32_t>(sz[0], sz[1], 0xfffff000);
+    Check<int32_t>(sz[0], sz[1], -1000);
+    Check<uint64_t>(sz[0], sz[1], 0x100000000ull);
+    Check<int64_t>(sz[0], sz[1], -5000000000ll);
+    Check<double>(sz[0], sz[1], -10.5);
+  }
+  // Sets of elements with key
+  typedef jnu::DArrayPair<std::string, int, jnu::ARR_OBJ_ALLOC, 8> SArr;
+  typedef jnu::ArrayMap<SArr> SMap;
+  SMap a;
+  SMap b;
+  for (int i = 0; i < 20; ++i) {
+    a.Insert(SArr::Type(std::to_string(i * 2), i));
+    b.Insert(SArr::Type(std::to_string(i * 3), -i));
+  }
+  SMap c;
+  JNU_UT_CHECK(jnu::algo::Intersect(a, b, c));
+  JNU_UT_EQUAL(c.Size(), 7);  // 0, 6, 12, ..., 36
+  JNU_UT_CHECK(c.Find("12") && c.Find("12")->Second() == 6);
+  JNU_UT_CHECK(jnu::algo::Difference(a, b, c));
+  JNU_UT_EQUAL(c.Size(), 13);
+  JNU_UT_CHECK(!c.Find("12") && c.Find("14"));
+  size_t n = jnu::algo::Union(a, b, [](const SArr::Type&) {});
+  JNU_UT_EQUAL(n, 33);
+}
@@ -3,9 +3,575 @@
 
 #include "jnu_array.h"
 #include "jnu_array_set.h"
+#include "jnu_array_set_parallel.h"
 #include "jnu_array_set_test.h"
+#include <vector>
+#include <algorithm>
 
 using namespace jnu_test;
+// Memory manager implementation counting allocations
+class CountAlloc {
+public:
+  // Allocate by buildin methods, counted
+  void* Malloc(const jnu::memory::Align& al, size_t sz) {
+    ++m_allocs;
+    return jnu::memory::Buildin::Malloc(al, sz);
+  }
+  // Free by buildin methods
+  void Free(void* ptr) {
+    jnu::memory::Buildin::Free(ptr);
+  }
+  size_t m_allocs = 0;  // Number of allocations
+};
+// Bulk insert test
+void ArraySetTest::TestBulk() {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr> ISet;  // Integer set
+  typedef jnu::DArrayPair<int, int, jnu::ARR_OBJ_ALLOC, 64> PArr;
+  typedef jnu::ArrayMap<PArr> PMap;  // Integer map
+  const static int ITEMS = 50000;  // Number of input items
+  jnu::ThreadPool p(3, 256);
+  // Pseudo random input with duplicates, some exist in set
+  std::vector<int> in(ITEMS);
+  unsigned int seed = 7;  // Random seed
+  for (int i = 0; i < ITEMS; ++i) {
+    seed = seed * 1103515245 + 12345;
+    in[i] = (seed >> 8) % (ITEMS * 2);
+  }
+  ISet s1, s2;
+  for (int i = 0; i < ITEMS * 2; i += 97) {
+    s1.Insert(i);
+    s2.Insert(i);
+  }
+  JNU_UT_CHECK(jnu::parallel::BulkInsert(p, s1, in.data(), in.size()));
+  JNU_UT_CHECK(s2.BulkInsert(in.data(), in.size()));  // Serial
+  std::vector<int> ref(in);  // Reference result
+  for (int i = 0; i < ITEMS * 2; i += 97) {
+    ref.push_back(i);
+  }
+  std::sort(ref.begin(), ref.end());
+  ref.erase(std::unique(ref.begin(), ref.end()), ref.end());
+  JNU_UT_EQUAL(s1.Size(), ref.size());
+  JNU_UT_EQUAL(s2.Size(), ref.size());
+  for (size_t i = 0; i < ref.size() && i < s1.Size(); ++i) {
+    JNU_UT_EQUAL(s1[i], ref[i]);
+    JNU_UT_EQUAL(s2[i], ref[i]);
+  }
+  // Empty input and input of existing keys only
+  JNU_UT_CHECK(jnu::parallel::BulkInsert(p, s1, in.data(), 0));
+  JNU_UT_CHECK(jnu::parallel::BulkInsert(p, s1, ref.data(), 100));
+  JNU_UT_EQUAL(s1.Size(), ref.size());
+  // Sort buffer is allocated by memory manager of set
+  jnu::memory::MM<CountAlloc> mm;
+  ISet s3(ITEMS * 2, &mm);  // Reserved, set does not grow
+  size_t allocs = mm.GetImp().m_allocs;  // Allocations of set
+  JNU_UT_CHECK(s3.BulkInsert(in.data(), 100));
+  JNU_UT_EQUAL(mm.GetImp().m_allocs, allocs + 1);
+  JNU_UT_CHECK(jnu::parallel::BulkInsert(p, s3, in.data(), in.size()));
+  JNU_UT_EQUAL(mm.GetImp().m_allocs, allocs + 2);
+  JNU_UT_CHECK(s3.Find(in[0]) && s3.Find(in[ITEMS - 1]));
+  // Duplicated keys of map, first or last input wins
+  PMap m1, m2;
+  PArr::Type e(5, -1);  // Existing element
+  m1.Insert(e);
+  m2.Insert(e);
+  std::vector<PArr::Type> pin(ITEMS);
+  for (int i = 0; i < ITEMS; ++i) {
+    pin[i] = PArr::Type(i % 1000, i);
+  }
+  JNU_UT_CHECK(jnu::parallel::BulkInject(p, m1, pin.data(), pin.size()));
+  JNU_UT_CHECK(jnu::parallel::ReplaceBulkInsert(p, m2, pin.data(), pin.size()));
+  JNU_UT_EQUAL(m1.Size(), 1000);
+  JNU_UT_EQUAL(m2.Size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    int first = i == 5 ? -1 : i;  // First value (existing wins)
+    int last = ITEMS - 1000 + i;  // Last value
+    JNU_UT_EQUAL(m1[i].First(), i);
+    JNU_UT_EQUAL(m1[i].Second(), first);
+    JNU_UT_EQUAL(m2[i].First(), i);
+    JNU_UT_EQUAL(m2[i].Second(), last);
+  }
+}
+// Sorted merge test
+void ArraySetTest::TestMerge() {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr> ISet;  // Integer set
+  typedef jnu::DArrayPair<int, std::string, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  typedef jnu::ArrayMap<PArr> PMap;  // Map of strings
+  // Interleaved runs, existing elements move once
+  ISet s;
+  std::vector<int> even, odd;
+  for (int i = 0; i < 2000; ++i) {
+    (i % 2 ? odd : even).push_back(i);
+  }
+  JNU_UT_CHECK(s.InsertSorted(even.data(), even.size()));
+  JNU_UT_CHECK(s.InsertSorted(odd.data(), odd.size()));
+  JNU_UT_EQUAL(s.Size(), 2000);
+  for (int i = 0; i < 2000; ++i) {
+    JNU_UT_EQUAL(s[i], i);
+  }
+  // Duplicated keys in input and set
+  int dup[] = {-5, -5, 0, 0, 3, 3000, 3000, 3001};
+  JNU_UT_CHECK(s.InsertSorted(dup, dup + 8));
+  JNU_UT_EQUAL(s.Size(), 2003);
+  JNU_UT_CHECK(s[0] == -5 && s[1] == 0 && s[2] == 1);
+  JNU_UT_CHECK(s[2001] == 3000 && s[2002] == 3001);
+  // Copy keeps input, first or last of equal keys wins
+  PMap m;
+  PArr::Type in[] = {PArr::Type(1, "a"), PArr::Type(3, "b"),
+                     PArr::Type(3, "c"), PArr::Type(5, "d")};
+  JNU_UT_CHECK(m.InsertSorted(in, 4));
+  JNU_UT_EQUAL(m.Size(), 3);
+  JNU_UT_EQUAL(m.Find(3)->Second(), "b");
+  JNU_UT_EQUAL(in[2].Second(), "c");
+  PArr::Type rep[] = {PArr::Type(0, "e"), PArr::Type(3, "f"),
+                      PArr::Type(3, "g"), PArr::Type(4, "h"),
+                      PArr::Type(4, "i"), PArr::Type(9, "j")};
+  JNU_UT_CHECK(m.ReplaceInjectSorted(rep, 6));
+  JNU_UT_EQUAL(m.Size(), 6);
+  JNU_UT_EQUAL(m[0].Second(), "e");
+  JNU_UT_EQUAL(m[1].Second(), "a");
+  JNU_UT_EQUAL(m[2].Second(), "g");
+  JNU_UT_EQUAL(m[3].Second(), "i");
+  JNU_UT_EQUAL(m[4].Second(), "d");
+  JNU_UT_EQUAL(m[5].Second(), "j");
+  JNU_UT_CHECK(rep[0].Second().empty());  // Moved
+  // Merge with hints keeps the old path
+  int late[] = {2500, 5000};
+  JNU_UT_CHECK(s.InsertSorted(late, 2, s.Begin() + 1000));
+  JNU_UT_EQUAL(s.Size(), 2005);
+  JNU_UT_CHECK(s[2001] == 2500 && s[2004] == 5000);
+}
+// Search of arithmetic keys, checked against std::lower_bound
+template<typename K>
+void ArraySetTest::CheckSearch(K base, K step) {
+  typedef jnu::DArray<K, jnu::ARR_MEM_ALLOC, 64> KArr;
+  jnu::ArraySet<KArr> s;
+  std::vector<K> ref;  // Reference sorted keys
+  for (int n = 0; n < 300; n += n < 40 ? 1 : 37) {  // Set sizes
+    s.Clear();
+    ref.clear();
+    for (int i = 0; i < n; ++i) {
+      ref.push_back(base + step * (K) i);
+    }
+    s.InsertSorted(ref.data(), ref.size());
+    for (int i = -1; i <= n; ++i) {  // On and between keys
+      for (K k : {base + step * (K) i, base + step * (K) i + step / 2}) {
+        auto lb = std::lower_bound(ref.begin(), ref.end(), k);
+        auto r = s.Locate(k);
+        JNU_UT_EQUAL(*r - s.Begin(), lb - ref.begin());
+        JNU_UT_EQUAL(r.Found(), lb != ref.end() && *lb == k);
+      }
+    }
+  }
+}
+// Branchless search test
+void ArraySetTest::TestSearch() {
+  CheckSearch<int>(-100, 4);
+  CheckSearch<unsigned int>(0x7fffff00, 2);
+  CheckSearch<long>(-5000000000, 1000);
+  CheckSearch<float>(-1.5, 0.25);
+  CheckSearch<double>(1e10, 0.5);
+  CheckSearch<short>(-300, 2);
+  // Lower bound of duplicated keys is the first one
+  int dup[40];
+  for (int i = 0; i < 40; ++i) {
+    dup[i] = i / 8;
+  }
+  JNU_UT_EQUAL(jnu::search::LowerBound(dup, dup + 40, 3), dup + 24);
+  JNU_UT_EQUAL(jnu::search::LowerBound(dup, dup + 40, 5), dup + 40);
+  // Elements with arithmetic key
+  typedef jnu::DArrayPair<int, std::string, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  jnu::ArrayMap<PArr> m;
+  for (int i = 0; i < 100; ++i) {
+    m.Insert(PArr::Type(i * 3, std::to_string(i)));
+  }
+  JNU_UT_EQUAL(m.Find(150)->Second(), "50");
+  JNU_UT_CHECK(!m.Find(151));
+  JNU_UT_EQUAL(*m.Locate(151), m.Begin() + 51);
+}
+// Batch find test
+void ArraySetTest::TestFindBatch() {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  jnu::ArraySet<IArr> s;
+  int k[100];
+  int* out[100];
+  for (int i = 0; i < 100; ++i) {
+    k[i] = i;
+  }
+  JNU_UT_EQUAL(s.FindBatch(k, 0, out), 0);
+  JNU_UT_EQUAL(s.FindBatch(k, 10, out), 0);  // Empty set
+  JNU_UT_CHECK(!out[0] && !out[9]);
+  for (int i = 0; i < 1000; ++i) {  // Even keys
+    s.Insert(i * 2);
+  }
+  for (int i = 0; i < 100; ++i) {  // Sorted, galloping
+    k[i] = i * i / 4 - 5;
+  }
+  size_t found = 0;  // Expected number found
+  for (int i = 0; i < 100; ++i) {
+    found += k[i] >= 0 && k[i] % 2 == 0 && k[i] < 2000;
+  }
+  JNU_UT_EQUAL(s.FindBatch(k, 100, out), found);
+  for (int i = 0; i < 100; ++i) {
+    JNU_UT_EQUAL(out[i], s.Find(k[i]));
+  }
+  for (int i = 0; i < 100; ++i) {  // Unsorted, interleaved
+    k[i] = (i * 7919) % 2011 - 3;
+  }
+  found = 0;
+  for (int i = 0; i < 100; ++i) {
+    found += k[i] >= 0 && k[i] % 2 == 0 && k[i] < 2000;
+  }
+  JNU_UT_EQUAL(s.FindBatch(k, 100, out), found);
+  for (int i = 0; i < 100; ++i) {
+    JNU_UT_EQUAL(out[i], s.Find(k[i]));
+  }
+  // Duplicated sorted keys find same element
+  int d[4] = {6, 6, 7, 1998};
+  JNU_UT_EQUAL(s.FindBatch(d, 4, out), 3);
+  JNU_UT_CHECK(out[0] == s.Begin() + 3 && out[1] == out[0]);
+  JNU_UT_CHECK(!out[2] && out[3] == s.End() - 1);
+}
+// Range query test
+void ArraySetTest::TestRange() {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  jnu::ArraySet<IArr> s;
+  JNU_UT_CHECK(s.Range(0, 10).IsEmpty());
+  for (int i = 0; i < 100; ++i) {  // Keys 0, 3, ..., 297
+    s.Insert(i * 3);
+  }
+  JNU_UT_EQUAL(s.LowerBound(30), s.Begin() + 10);
+  JNU_UT_EQUAL(s.UpperBound(30), s.Begin() + 11);
+  JNU_UT_EQUAL(s.LowerBound(31), s.Begin() + 11);
+  JNU_UT_EQUAL(s.UpperBound(31), s.Begin() + 11);
+  JNU_UT_EQUAL(s.UpperBound(1000), s.End());
+  auto eq = s.EqualRange(30);
+  JNU_UT_CHECK(eq.Size() == 1 && eq[0] == 30);
+  JNU_UT_CHECK(s.EqualRange(31).IsEmpty());
+  auto v = s.Range(10, 40);  // 12 ... 39
+  JNU_UT_CHECK(v.Begin() == s.Begin() + 4 && v.End() == s.Begin() + 14);
+  JNU_UT_CHECK(v[0] == 12 && v[v.Size() - 1] == 39);
+  JNU_UT_CHECK(s.Range(40, 10).IsEmpty());
+  JNU_UT_EQUAL(s.CountRange(-10, 1000), 100);
+  JNU_UT_EQUAL(s.CountRange(0, 3), 1);
+  JNU_UT_EQUAL(s.CountRange(1, 3), 0);
+  // Hints give same results
+  int* h = s.Begin() + 50;
+  JNU_UT_EQUAL(s.LowerBound(30, h), s.Begin() + 10);
+  JNU_UT_EQUAL(s.UpperBound(150, h), s.Begin() + 51);
+  JNU_UT_EQUAL(s.CountRange(10, 160, h, s.Begin() + 3), 50);
+  // Time window of map
+  typedef jnu::DArrayPair<int, std::string, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  jnu::ArrayMap<PArr> m;
+  for (int i = 0; i < 50; ++i) {
+    m.Insert(PArr::Type(i * 10, std::to_string(i)));
+  }
+  auto w = m.Range(95, 135);
+  JNU_UT_EQUAL(w.Size(), 4);
+  JNU_UT_CHECK(w[0].Second() == "10" && w[3].Second() == "13");
+}
+// Search by other key types test
+void ArraySetTest::TestTransparent() {
+  // Views compare with strings both ways
+  jnu::StringView v("bb");
+  JNU_UT_CHECK(std::string("ba") < v && std::string("bc") > v);
+  JNU_UT_CHECK(std::string("bb") == v && std::string("b") != v);
+  JNU_UT_CHECK("a" < v && !(v < v));
+  // Strings found by views, default comparison
+  typedef jnu::DArrayPair<std::string, int, jnu::ARR_OBJ_ALLOC, 8> SArr;
+  jnu::ArrayMap<SArr> m;
+  const char* keys[] = {"accept", "host", "cookie", "content-type"};
+  for (int i = 0; i < 4; ++i) {
+    m.Insert(SArr::Type(keys[i], i));
+  }
+  const char* line = "Host: example.com";
+  jnu::StringView name(line, 4);
+  JNU_UT_CHECK(!m.Find(name));  // Case sensitive
+  JNU_UT_CHECK(!m.Find(jnu::StringView(line + 6, 3)));
+  JNU_UT_EQUAL(m.Find(jnu::StringView("host"))->Second(), 1);
+  JNU_UT_EQUAL(m.Find("cookie")->Second(), 2);
+  JNU_UT_EQUAL((m.CountRange(jnu::StringView("c"), "d")), 2);
+  JNU_UT_EQUAL(m.LowerBound(jnu::StringView("d")), m.Begin() + 3);
+  JNU_UT_EQUAL(m.UpperBound(jnu::StringView("host")), m.End());
+  JNU_UT_EQUAL(m.EqualRange(jnu::StringView("accept")).Size(), 1);
+  JNU_UT_EQUAL(m.Locate(jnu::StringView("b"), m.Begin() + 2).Found(),
+               false);
+  // Case insensitive comparator object
+  jnu::ArrayMap<SArr, &jnu::STRING_LESS_CASE> c;
+  for (int i = 0; i < 4; ++i) {
+    c.Insert(SArr::Type(keys[i], i));
+  }
+  JNU_UT_EQUAL(c.Find(name)->Second(), 1);
+  JNU_UT_EQUAL(c.Find("CONTENT-TYPE")->Second(), 3);
+  JNU_UT_CHECK(!c.Find(jnu::StringView("Content")));
+  // Library strings as keys
+  typedef jnu::DString<8> DStr;
+  typedef jnu::DArrayPair<DStr, int, jnu::ARR_OBJ_ALLOC, 8> DArr;
+  jnu::ArrayMap<DArr, &jnu::STRING_LESS> d;
+  for (int i = 0; i < 4; ++i) {
+    d.Insert(DArr::Type(DStr(keys[i]), i));
+  }
+  JNU_UT_EQUAL(d.Find(jnu::StringView("cookie"))->Second(), 2);
+  JNU_UT_EQUAL(d.Find(std::string("accept"))->Second(), 0);
+  JNU_UT_EQUAL(d.Find(DStr("host"))->Second(), 1);
+  JNU_UT_CHECK(!d.Find("hos"));
+  JNU_UT_EQUAL((d.Range("b", jnu::StringView("d")).Size()), 2);
+  // Function comparison converts search keys
+  jnu::ArrayMap<SArr, Greater> g;
+  for (int i = 0; i < 4; ++i) {
+    g.Insert(SArr::Type(keys[i], i));
+  }
+  JNU_UT_EQUAL(g.Begin()->First(), "host");
+  JNU_UT_EQUAL(g.Find("accept")->Second(), 0);
+  // Arithmetic search keys are converted without loss
+  jnu::ArraySet<jnu::DArray<long, jnu::ARR_MEM_ALLOC, 8>> l;
+  l.Insert(5L);
+  l.Insert(7L);
+  JNU_UT_EQUAL(l.Find(7), l.Begin() + 1);
+  JNU_UT_EQUAL(l.Find((short) 5), l.Begin());
+  JNU_UT_EQUAL(l.Find(7u), l.Begin() + 1);
+  // Otherwise compared with keys directly
+  jnu::ArraySet<jnu::DArray<int, jnu::ARR_MEM_ALLOC, 8>> n;
+  n.Insert(5);
+  n.Insert(6);
+  n.Insert(7);
+  JNU_UT_CHECK(!n.Find(5.5));
+  JNU_UT_EQUAL(n.Find(6.0), n.Begin() + 1);
+  JNU_UT_EQUAL(n.LowerBound(5.5), n.Begin() + 1);
+  JNU_UT_EQUAL(n.UpperBound(5.5), n.Begin() + 1);
+  JNU_UT_EQUAL(n.LowerBound(6.5), n.Begin() + 2);
+  JNU_UT_EQUAL(n.LowerBound(-0.5), n.Begin());
+  JNU_UT_EQUAL((n.CountRange(5.5, 7.5)), 2);
+  JNU_UT_CHECK(!n.GetCursor().Find(5.5));
+  // Signed search keys of unsigned keys, negative keys first
+  jnu::ArraySet<jnu::DArray<uint32_t, jnu::ARR_MEM_ALLOC, 8>> u;
+  u.Insert(2u);
+  u.Insert(0xFFFFFFFFu);
+  JNU_UT_EQUAL(u.Find(2), u.Begin());
+  JNU_UT_CHECK(!u.Find(-1));
+  JNU_UT_EQUAL(u.LowerBound(-1), u.Begin());
+  JNU_UT_EQUAL(u.UpperBound(-1), u.Begin());
+  JNU_UT_EQUAL(u.LowerBound(3), u.Begin() + 1);
+  JNU_UT_EQUAL(u.LowerBound(0x100000000L), u.End());
+  JNU_UT_EQUAL((u.CountRange(-5, 3)), 1);
+  JNU_UT_EQUAL(u.GetCursor().Find(2), u.Begin());
+  jnu::ArraySet<jnu::DArray<size_t, jnu::ARR_MEM_ALLOC, 8>> z;
+  z.Insert((size_t) 0);
+  z.Insert((size_t) 4);
+  JNU_UT_EQUAL(z.Find(4), z.Begin() + 1);
+  JNU_UT_EQUAL(z.Find(0), z.Begin());
+  JNU_UT_CHECK(!z.Find(-4));
+  JNU_UT_EQUAL(z.LowerBound(-4), z.Begin());
+  JNU_UT_EQUAL(z.UpperBound(4), z.End());
+  // Integer search keys of floating point keys
+  jnu::ArraySet<jnu::DArray<float, jnu::ARR_MEM_ALLOC, 8>> f;
+  f.Insert(-1.5f);
+  f.Insert(2.0f);
+  f.Insert(16777216.0f);
+  JNU_UT_EQUAL(f.Find(2), f.Begin() + 1);
+  JNU_UT_CHECK(!f.Find(-1));
+  JNU_UT_EQUAL(f.LowerBound(-1), f.Begin() + 1);
+  JNU_UT_EQUAL(f.LowerBound(-2), f.Begin());
+  JNU_UT_EQUAL(f.Find(16777216), f.Begin() + 2);
+  // 16777217 is not a float, rounds to the key 16777216
+  JNU_UT_CHECK(!f.Find(16777217));
+  JNU_UT_EQUAL(f.LowerBound(16777217), f.End());
+  JNU_UT_EQUAL(f.UpperBound(16777215), f.Begin() + 2);
+  // Floating point search keys out of range of integer keys
+  JNU_UT_CHECK(!u.Find(4294967296.0));
+  JNU_UT_EQUAL(u.LowerBound(4294967296.0), u.End());
+  JNU_UT_EQUAL(u.LowerBound(-0.5), u.Begin());
+  JNU_UT_EQUAL(n.LowerBound(3e10), n.End());
+  JNU_UT_EQUAL(n.LowerBound(-3e10), n.Begin());
+  JNU_UT_EQUAL(l.LowerBound(6.5), l.Begin() + 1);
+  JNU_UT_CHECK(!l.Find(6.5));
+}
+// Equal keys test
+void ArraySetTest::TestMulti() {
+  typedef jnu::DArrayPair<int, int, jnu::ARR_OBJ_ALLOC, 8> PArr;
+  typedef PArr::Type P;
+  typedef jnu::ArrayMultiMap<PArr> MMap;
+  MMap m;
+  std::vector<P> all;  // All elements in insertion order
+  // Compare with stable sort of all elements by key
+  auto check = [&]() {
+    std::vector<P> ref(all);
+    std::stable_sort(ref.begin(), ref.end(), [](const P& a, const P& b) {
+      return a.First() < b.First(); });
+    JNU_UT_EQUAL(m.Size(), ref.size());
+    for (size_t i = 0; i < ref.size() && i < m.Size(); ++i) {
+      JNU_UT_EQUAL(m[i].First(), ref[i].First());
+      JNU_UT_EQUAL(m[i].Second(), ref[i].Second());
+    }
+  };
+  int seq = 0;  // Insertion order
+  for (int i = 0; i < 300; ++i) {  // Single insertions
+    P p((i * 37) % 23, seq++);
+    JNU_UT_CHECK(m.Insert(p).Inserted());
+    all.push_back(p);
+  }
+  check();
+  for (int i = 0; i < 50; ++i) {  // Insertions with hints
+    P p((i * 7) % 30, seq++);
+    m.ReplaceInsert(p, m.Begin() + m.Size() / 2, m.Begin() + 3);
+    all.push_back(p);
+  }
+  check();
+  std::vector<P> in;
+  for (int i = 0; i < 100; ++i) {
+    in.push_back(P(i / 4, seq++));
+  }
+  // Sorted merge, with and without hints
+  JNU_UT_CHECK(m.InsertSorted(in.data(), 50, m.Begin() + 100));
+  all.insert(all.end(), in.begin(), in.begin() + 50);
+  check();
+  JNU_UT_CHECK(m.InsertSorted(in.data() + 50, 50));
+  all.insert(all.end(), in.begin() + 50, in.end());
+  check();
+  // Bulk insertion of unsorted input with equal keys
+  in.clear();
+  for (int i = 0; i < 200; ++i) {
+    in.push_back(P((i * 13) % 40 - 5, seq++));
+  }
+  JNU_UT_CHECK(m.BulkInsert(in.data(), in.size()));
+  all.insert(all.end(), in.begin(), in.end());
+  check();
+  // Searches find first and end of equal keys
+  for (int k = -6; k < 36; ++k) {
+    MMap::View v = m.EqualRange(k);
+    size_t n = std::count_if(all.begin(), all.end(), [k](const P& p) {
+      return p.First() == k; });
+    JNU_UT_EQUAL(v.Size(), n);
+    JNU_UT_EQUAL(v.Begin(), m.LowerBound(k));
+    JNU_UT_EQUAL(v.End(), m.UpperBound(k));
+    if (n) {
+      JNU_UT_EQUAL(m.Find(k), v.Begin());
+      JNU_UT_EQUAL(*m.Locate(k, v.End() - 1), v.Begin());
+      JNU_UT_EQUAL(v.Begin()[0].First(), k);
+    }
+    JNU_UT_CHECK(v.Begin() == m.Begin() || v.Begin()[-1].First() < k);
+  }
+  JNU_UT_EQUAL(m.CountRange(0, 5),
+               (size_t) std::count_if(all.begin(), all.end(),
+                                      [](const P& p) {
+                 return p.First() >= 0 && p.First() < 5; }));
+  // Delete one of equal keys
+  P* p = m.Find(3);
+  int second = p[1].Second();
+  m.Delete(p, 1);
+  JNU_UT_EQUAL(m.Find(3)->Second(), second);
+  // Set of equal elements
+  jnu::ArrayMultiSet<jnu::DArray<int, jnu::ARR_MEM_ALLOC, 8>> s;
+  int ins[] = {3, 1, 3, 2, 3};
+  JNU_UT_CHECK(s.Insert(ins, 5));
+  JNU_UT_EQUAL(s.Size(), 5);
+  JNU_UT_EQUAL(s.EqualRange(3).Size(), 3);
+  JNU_UT_EQUAL(s.UpperBound(1), s.Begin() + 1);
+  JNU_UT_EQUAL(s.Find(3), s.Begin() + 2);
+}
+// Number of key comparisons
+static size_t compares = 0;
+// Less comparison, counted
+static bool CountLess(const int& a, const int& b) {
+  ++compares;
+  return a < b;
+}
+// Finger search and cursor test
+void ArraySetTest::TestFinger() {
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr, CountLess> CSet;  // Counted set
+  typedef jnu::ArraySet<IArr, CountLess, jnu::ARR_SET_FINGER> FSet;
+  typedef jnu::DArrayPair<int, int, jnu::ARR_OBJ_ALLOC, 64> PArr;
+  typedef jnu::ArrayMap<PArr> PMap;
+  typedef jnu::ArrayMap<PArr, (bool (*) (const int&, const int&)) NULL,
+                        jnu::ARR_SET_FINGER> FMap;
+  const static int ITEMS = 1 << 16;  // Number of elements
+  // Appends (time series) cost a few comparisons each
+  FSet f;
+  CSet c;
+  compares = 0;
+  for (int i = 0; i < ITEMS; ++i) {
+    f.Insert(i * 2);
+  }
+  JNU_UT_EQUAL(f.Size(), (size_t) ITEMS);
+  JNU_UT_CHECK(compares < (size_t) ITEMS * 4);
+  for (int i = 0; i < ITEMS; ++i) {
+    c.Insert(i * 2);
+  }
+  // Near sorted lookups, same results, fewer comparisons
+  unsigned int seed = 3;  // Random seed
+  int key = 0;  // Random walk key
+  size_t fc = 0;  // Comparisons of finger search
+  size_t cc = 0;  // Comparisons of binary search
+  for (int i = 0; i < 10000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    key = JNU_MAX(key + (int) ((seed >> 8) % 9) - 3, -2);
+    compares = 0;
+    int* p = f.Find(key);
+    fc += compares;
+    size_t lo = f.LowerBound(key) - f.Begin();
+    compares = 0;
+    int* q = c.Find(key);
+    cc += compares;
+    JNU_UT_EQUAL(p ? p - f.Begin() : -1, q ? q - c.Begin() : -1);
+    JNU_UT_EQUAL(lo, (size_t) (c.LowerBound(key) - c.Begin()));
+  }
+  JNU_UT_CHECK(fc * 3 < cc);
+  // Finger out of set after deletion, and hints with finger
+  f.Delete(f.Begin() + ITEMS / 2, f.End());
+  JNU_UT_EQUAL(f.Find(ITEMS), (int*) NULL);
+  JNU_UT_EQUAL(*f.Find(ITEMS - 2), ITEMS - 2);
+  JNU_UT_EQUAL(*f.Find(4, f.Begin() + 100), 4);
+  JNU_UT_EQUAL(f.LowerBound(ITEMS * 4), f.End());
+  JNU_UT_EQUAL(f.LowerBound(-1), f.Begin());
+  JNU_UT_CHECK(f.Insert(ITEMS + 1).Inserted());
+  JNU_UT_EQUAL(*f.RBegin(), ITEMS + 1);
+  f.Clear();
+  JNU_UT_EQUAL(f.Find(0), (int*) NULL);
+  JNU_UT_CHECK(f.Insert(0).Inserted());
+  // Map with finger, walking over keys both ways
+  FMap fm;
+  PMap pm;
+  for (int i = 0; i < 1000; ++i) {
+    PArr::Type t((i * 7) % 1000, i);
+    fm.Insert(t);
+    pm.Insert(t);
+  }
+  for (int k = 1010; k > -10; k -= 3) {
+    PArr::Type* p = fm.Find(k);
+    PArr::Type* q = pm.Find(k);
+    JNU_UT_EQUAL(p == NULL, q == NULL);
+    JNU_UT_CHECK(!p || p->Second() == q->Second());
+  }
+  // Equal keys with finger find the first one
+  jnu::ArrayMultiSet<IArr, (bool (*) (const int&, const int&)) NULL,
+                     jnu::ARR_SET_FINGER> m;
+  for (int i = 0; i < 100; ++i) {
+    m.Insert(i / 10);
+  }
+  JNU_UT_EQUAL(m.Find(9), m.Begin() + 90);
+  JNU_UT_EQUAL(m.Find(5), m.Begin() + 50);
+  JNU_UT_EQUAL(m.Find(5, m.Begin() + 55), m.Begin() + 50);
+  JNU_UT_EQUAL(m.EqualRange(7).Size(), 10);
+  // Cursors of a set without finger
+  CSet::Cursor cur = c.GetCursor();
+  JNU_UT_EQUAL(cur.Position(), c.Begin());
+  compares = 0;
+  for (int k = 0; k < 2000; ++k) {
+    JNU_UT_EQUAL(cur.Find(k), k % 2 ? NULL : c.Begin() + k / 2);
+    JNU_UT_EQUAL(cur.LowerBound(k), c.Begin() + (k + 1) / 2);
+  }
+  JNU_UT_CHECK(compares < 2000 * 2 * 6);
+  CSet::Cursor back = c.GetCursor(c.End() - 1);
+  JNU_UT_EQUAL(back.Find(ITEMS * 2 - 4), c.End() - 2);
+  JNU_UT_EQUAL(back.Position(), c.End() - 2);
+  JNU_UT_EQUAL(back.Find(1), (int*) NULL);
+  JNU_UT_EQUAL(back.Find(0), c.Begin());
+  c.Clear();
+  JNU_UT_EQUAL(back.Find(0), (int*) NULL);
+  JNU_UT_EQUAL(back.Position(), c.Begin());
+}
 // Main test entry
 void ArraySetTest::Test() {
   // Hybrid array of pair<string, TestObj>
@@ -83,4 +649,18 @@ void ArraySetTest::Test() {
   // Clear and free memory
   m1.Free();
   JNU_UT_CHECK(m1.IsEmpty());
+  // Insert result stays valid when array grows
+  jnu::ArraySet<jnu::DArray<int, jnu::ARR_MEM_ALLOC, 4>> g;
+  for (int i = 0; i < 100; ++i) {
+    auto r = g.Insert(i);
+    JNU_UT_CHECK(*r >= g.Begin() && *r < g.End() && **r == i);
+  }
+  TestBulk();  // Bulk insert
+  TestMerge();  // Sorted merge
+  TestSearch();  // Branchless search
+  TestFindBatch();  // Batch find
+  TestRange();  // Range query
+  TestTransparent();  // Search by other key types
+  TestMulti();  // Equal keys
+  TestFinger();  // Finger search and cursor
 }
@@ -0,0 +1,135 @@
+// By JNI
+// Implementation of concurrent container tests
+
+#include "jnu_atomic_list_test.h"
+#include <thread>
+#include <vector>
+
+using namespace jnu_test;
+
+// Test of lock-free stack
+void AtomicStackTest::Test() {
+  Stack s;
+  AItem a, b, c, d;
+  JNU_UT_CHECK(s.IsEmpty());
+  JNU_UT_EQUAL(s.Pop(), NULL);
+  s.Push(a);
+  s.Push(b);
+  JNU_UT_EQUAL(s.Pop(), &b);
+  // Push list c->d, stack becomes c->d->a
+  Stack::List ls;
+  ls.InsertTail(c);
+  ls.InsertTail(d);
+  s.Push(std::move(ls));
+  JNU_UT_CHECK(ls.IsEmpty());
+  JNU_UT_EQUAL(s.Pop(), &c);
+  s.Push(b);
+  // Pop all: b->d->a
+  ls = s.PopAll();
+  JNU_UT_CHECK(s.IsEmpty());
+  JNU_UT_EQUAL(ls.Size(), 3);
+  JNU_UT_EQUAL(ls.Head(), &b);
+  JNU_UT_EQUAL(ls.Next(b), &d);
+  JNU_UT_EQUAL(ls.Tail(), &a);
+  JNU_UT_EQUAL(ls.Next(a), NULL);
+  // Concurrent pop and push of a shared pool
+  const static int ITEMS = 64;  // Pool size
+  const static int THREADS = 4;  // Number of threads
+  const static int LOOPS = 20000;  // Loops per thread
+  std::vector<AItem> pool(ITEMS);
+  for (int i = 0; i < ITEMS; ++i) {
+    pool[i].m_val = 0;
+    s.Push(pool[i]);
+  }
+  std::thread t[THREADS];
+  for (int i = 0; i < THREADS; ++i) {
+    t[i] = std::thread([&s]() {
+      for (int j = 0; j < LOOPS; ++j) {
+        if (AItem* item = s.Pop()) {
+          ++item->m_val;  // Owned exclusively until pushed back
+          s.Push(*item);
+        }
+        if (j % 1000 == 0) {  // Steal and return everything
+          s.Push(s.PopAll());
+        }
+      }
+    });
+  }
+  for (int i = 0; i < THREADS; ++i) {
+    t[i].join();
+  }
+  // No object is lost or duplicated
+  ls = s.PopAll();
+  JNU_UT_EQUAL(ls.Size(), ITEMS);
+  int total = 0;
+  for (AItem* i = ls.Head(); i; i = ls.Next(*i)) {
+    total += i->m_val;
+  }
+  JNU_UT_CHECK(total > 0 && total <= THREADS * LOOPS);
+}
+// Test of multiple producers single consumer queue
+void MpscQueueTest::Test() {
+  Queue q;
+  AItem a, b, c, d;
+  JNU_UT_CHECK(q.IsEmpty());
+  JNU_UT_EQUAL(q.Pop(), NULL);
+  q.Push(a);
+  q.Push(b);
+  JNU_UT_CHECK(!q.IsEmpty());
+  JNU_UT_EQUAL(q.Pop(), &a);
+  JNU_UT_EQUAL(q.Pop(), &b);
+  JNU_UT_EQUAL(q.Pop(), NULL);
+  JNU_UT_CHECK(q.IsEmpty());
+  // Push list c->d after a
+  Queue::List ls;
+  ls.InsertTail(c);
+  ls.InsertTail(d);
+  q.Push(a);
+  q.Push(std::move(ls));
+  JNU_UT_CHECK(ls.IsEmpty());
+  // Drain a->c->d
+  JNU_UT_EQUAL(q.DrainTo(ls), 3);
+  JNU_UT_EQUAL(ls.Head(), &a);
+  JNU_UT_EQUAL(ls.Next(a), &c);
+  JNU_UT_EQUAL(ls.Tail(), &d);
+  JNU_UT_CHECK(q.IsEmpty());
+  // Concurrent producers
+  const static int THREADS = 4;  // Number of producers
+  const static int ITEMS = 5000;  // Objects per producer
+  std::vector<AItem> items[THREADS];
+  std::thread t[THREADS];
+  for (int i = 0; i < THREADS; ++i) {
+    items[i].resize(ITEMS);
+    t[i] = std::thread([&q, &items, i]() {
+      for (int j = 0; j < ITEMS; ++j) {
+        items[i][j].m_val = i * ITEMS + j;
+        q.Push(items[i][j]);
+      }
+    });
+  }
+  // Objects of each producer are received in order
+  int last[THREADS] = {-1, -1, -1, -1};
+  int received = 0;
+  bool ordered = true;
+  while (received < THREADS * ITEMS) {
+    if (AItem* item = q.Pop()) {
+      int p = item->m_val / ITEMS;
+      ordered = ordered && item->m_val > last[p];
+      last[p] = item->m_val;
+      ++received;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (int i = 0; i < THREADS; ++i) {
+    t[i].join();
+  }
+  JNU_UT_CHECK(ordered);
+  JNU_UT_EQUAL(received, THREADS * ITEMS);
+  JNU_UT_CHECK(q.IsEmpty());
+}
+// Main test entry
+void AtomicListTest::Test() {
+  Run<AtomicStackTest>("atomic stack");  // Lock-free stack
+  Run<MpscQueueTest>("mpsc queue");  // Multiple producers queue
+}
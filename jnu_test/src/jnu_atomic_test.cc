@@ -0,0 +1,92 @@
+// By JNI
+// Test cases of atomic wraps
+
+#include "jnu_atomic_test.h"
+#include <thread>
+
+using namespace jnu_test;
+
+// Atomic types used in tests
+typedef jnu::atomic::Type<> Atomic;
+
+// Test of integer operations
+void AtomicTest::TestInteger() {
+  Atomic::Int a(10);
+  JNU_UT_EQUAL(a.FetchAdd(5), 10);
+  JNU_UT_EQUAL(a.SubFetch(3), 12);
+  // Min and max only write when needed
+  JNU_UT_EQUAL(a.FetchMin(20), 12);
+  JNU_UT_EQUAL(a.Load(), 12);
+  JNU_UT_EQUAL(a.FetchMin(-4), 12);
+  JNU_UT_EQUAL(a.Load(), -4);
+  JNU_UT_EQUAL(a.MaxFetch(-8), -4);
+  JNU_UT_EQUAL(a.MaxFetch(7), 7);
+  JNU_UT_EQUAL(a.MinFetch(3), 3);
+  JNU_UT_CHECK(!a.CompareExchange(4, 5));
+  JNU_UT_CHECK(a.CompareExchange(3, 5) || a.CompareExchange(3, 5));
+  JNU_UT_EQUAL(a.Exchange(9), 5);
+  JNU_UT_EQUAL(a.Load(), 9);
+  // Strong exchange never fails spuriously
+  int e = 4;
+  JNU_UT_CHECK(!a.CompareExchangeStrong(e, 5));
+  JNU_UT_EQUAL(e, 9);  // Updated with current value
+  JNU_UT_CHECK(a.CompareExchangeStrong(e, 6));
+  JNU_UT_EQUAL(a.Load(), 6);
+}
+// Test of floating point operations
+void AtomicTest::TestFloat() {
+  // Note: JNU_UT_CLOSE evaluates its arguments twice
+  Atomic::Double d(1.5);
+  double r = d.FetchAdd(2.25);
+  JNU_UT_CLOSE(r, 1.5, 1e-12);
+  JNU_UT_CLOSE(d.Load(), 3.75, 1e-12);
+  r = d.SubFetch(0.75);
+  JNU_UT_CLOSE(r, 3.0, 1e-12);
+  d += 1.0;
+  JNU_UT_CLOSE((double) d, 4.0, 1e-12);
+  ++d;
+  r = d.FetchSub(5.0);
+  JNU_UT_CLOSE(r, 5.0, 1e-12);
+  r = d.FetchMax(-1.0);
+  JNU_UT_CLOSE(r, 0.0, 1e-12);
+  JNU_UT_CLOSE(d.Load(), 0.0, 1e-12);
+  r = d.MaxFetch(2.5);
+  JNU_UT_CLOSE(r, 2.5, 1e-12);
+  r = d.MinFetch(-2.5);
+  JNU_UT_CLOSE(r, -2.5, 1e-12);
+  Atomic::Float f(0.5f);
+  float g = f.AddFetch(0.25f);
+  JNU_UT_CLOSE(g, 0.75f, 1e-6f);
+  g = f.Exchange(2.0f);
+  JNU_UT_CLOSE(g, 0.75f, 1e-6f);
+  JNU_UT_CHECK(f.CompareExchange(2.0f, 3.0f) ||
+               f.CompareExchange(2.0f, 3.0f));
+  JNU_UT_CLOSE(f.Load(), 3.0f, 1e-6f);
+}
+// Test of concurrent updates
+void AtomicTest::TestConcurrent() {
+  const static int THREADS = 4;  // Number of threads
+  const static int LOOPS = 10000;  // Updates per thread
+  Atomic::Double sum(0.0);  // Running sum
+  Atomic::Double max(0.0);  // Running maximum
+  std::thread t[THREADS];
+  for (int i = 0; i < THREADS; ++i) {
+    t[i] = std::thread([&sum, &max, i]() {
+      for (int j = 0; j < LOOPS; ++j) {
+        sum.FetchAdd(0.5);
+        max.FetchMax(i * LOOPS + j);
+      }
+    });
+  }
+  for (int i = 0; i < THREADS; ++i) {
+    t[i].join();
+  }
+  JNU_UT_CLOSE(sum.Load(), THREADS * LOOPS * 0.5, 1e-9);
+  JNU_UT_CLOSE(max.Load(), THREADS * LOOPS - 1, 1e-9);
+}
+// Main test entry
+void AtomicTest::Test() {
+  TestInteger();  // Integer operations
+  TestFloat();  // Floating point operations
+  TestConcurrent();  // Concurrent updates
+}
@@ -0,0 +1,84 @@
+// By JNI
+// Test cases of atomic bitset
+
+#include "jnu_bitset_test.h"
+#include <thread>
+#include <vector>
+
+using namespace jnu_test;
+
+// Test of single thread allocation
+void BitsetTest::TestAllocate() {
+  jnu::AtomicBitset<130> s;  // Static bitset
+  JNU_UT_EQUAL(s.Size(), 130);
+  JNU_UT_EQUAL(s.Count(), 0);
+  bool all = true;  // All slots are unique
+  for (size_t i = 0; i < 130; ++i) {
+    size_t slot = s.Allocate();
+    all = all && slot < 130 && s.Test(slot);
+  }
+  JNU_UT_CHECK(all);
+  JNU_UT_EQUAL(s.Count(), 130);
+  // Padding bits are never allocated
+  JNU_UT_EQUAL(s.Allocate(), jnu::AtomicBitset<130>::NPOS);
+  s.Free(77);
+  JNU_UT_CHECK(!s.Test(77));
+  JNU_UT_EQUAL(s.Allocate(), 77);
+  s.Free(5);
+  JNU_UT_CHECK(s.Acquire(5));
+  JNU_UT_CHECK(!s.Acquire(5));
+  JNU_UT_CHECK(!s.Acquire(130));
+  s.Reset();
+  JNU_UT_EQUAL(s.Count(), 0);
+  // Dynamic bitset
+  jnu::DAtomicBitset d(10);
+  JNU_UT_EQUAL(d.Size(), 10);
+  JNU_UT_CHECK(d.Acquire(9));
+  JNU_UT_CHECK(d.Resize(200));
+  JNU_UT_EQUAL(d.Size(), 200);
+  JNU_UT_CHECK(!d.Test(9));
+  for (size_t i = 0; i < 200; ++i) {
+    d.Allocate();
+  }
+  JNU_UT_EQUAL(d.Count(), 200);
+  JNU_UT_EQUAL(d.Allocate(), jnu::DAtomicBitset::NPOS);
+}
+// Test of concurrent allocation
+void BitsetTest::TestConcurrent() {
+  const static size_t THREADS = 4;  // Number of threads
+  const static size_t SLOTS = 1000;  // Slots per thread
+  jnu::DAtomicBitset d(THREADS * SLOTS);
+  std::vector<size_t> res[THREADS];  // Allocated slots
+  std::thread t[THREADS];
+  for (size_t i = 0; i < THREADS; ++i) {
+    t[i] = std::thread([&d, &res, i]() {
+      for (size_t j = 0; j < SLOTS; ++j) {
+        size_t slot = d.Allocate();
+        // Free and allocate again to create contention
+        if (j & 1) {
+          d.Free(slot);
+          slot = d.Allocate();
+        }
+        res[i].push_back(slot);
+      }
+    });
+  }
+  for (size_t i = 0; i < THREADS; ++i) {
+    t[i].join();
+  }
+  // Every slot is handed out exactly once
+  std::vector<int> seen(THREADS * SLOTS, 0);
+  bool unique = true;
+  for (size_t i = 0; i < THREADS; ++i) {
+    for (size_t slot : res[i]) {
+      unique = unique && slot < seen.size() && !seen[slot]++;
+    }
+  }
+  JNU_UT_CHECK(unique);
+  JNU_UT_EQUAL(d.Count(), THREADS * SLOTS);
+}
+// Main test entry
+void BitsetTest::Test() {
+  TestAllocate();  // Single thread allocation
+  TestConcurrent();  // Concurrent allocation
+}
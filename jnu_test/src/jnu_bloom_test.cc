@@ -0,0 +1,95 @@
+// By JNI
+// Implementation of blocked Bloom filter tests
+
+#include "jnu_bloom_test.h"
+#include <vector>
+
+using namespace jnu_test;
+
+// Main test entry
+void BloomTest::Test() {
+  // Empty filter has no keys
+  jnu::BloomFilter<int> f;
+  JNU_UT_CHECK(!f.MayContain(1));
+  JNU_UT_CHECK(f.Add(1) && f.MayContain(1));
+  // No false negative, few false positives
+  JNU_UT_CHECK(f.Reset(10000));
+  JNU_UT_EQUAL(f.Size(), 0);
+  JNU_UT_CHECK(!f.MayContain(1));
+  for (int i = 0; i < 10000; ++i) {
+    f.Add(i * 2);
+  }
+  int fp = 0;  // False positives
+  for (int i = 0; i < 10000; ++i) {
+    JNU_UT_CHECK(f.MayContain(i * 2));
+    fp += f.MayContain(i * 2 + 1);
+  }
+  JNU_UT_CHECK(fp < 300);
+  JNU_UT_CHECK(!f.IsSaturated());
+  f.Clear();
+  JNU_UT_CHECK(!f.MayContain(2));
+  // Deduplication of strings
+  jnu::BloomFilter<std::string> d;
+  JNU_UT_CHECK(d.Reset(100));
+  JNU_UT_CHECK(!d.TestAndAdd("abc"));
+  JNU_UT_CHECK(!d.TestAndAdd("abd"));
+  JNU_UT_CHECK(d.TestAndAdd("abc"));
+  JNU_UT_EQUAL(d.Size(), 2);
+  // Filtered set
+  jnu::BloomSet<ISet> s;
+  JNU_UT_CHECK(!s.Find(0));
+  for (int i = 0; i < 1000; ++i) {
+    JNU_UT_CHECK(s.Insert(i * 3).Inserted());
+  }
+  JNU_UT_CHECK(!s.Insert(3).Inserted());
+  JNU_UT_EQUAL(s.Size(), 1000);
+  JNU_UT_CHECK(!s.GetFilter().IsSaturated());
+  for (int k = -5; k < 3005; ++k) {
+    int* p = s.Find(k);
+    if (k >= 0 && k % 3 == 0 && k < 3000) {
+      JNU_UT_CHECK(p && *p == k);
+    } else {
+      JNU_UT_CHECK(!p);
+    }
+  }
+  // Deletes rebuild the filter
+  for (int i = 0; i < 500; ++i) {
+    JNU_UT_CHECK(s.Delete(i * 3));
+  }
+  JNU_UT_CHECK(!s.Delete(0));
+  JNU_UT_CHECK(s.GetFilter().Size() < 1000);
+  JNU_UT_CHECK(!s.Find(300) && s.Find(1500));
+  // Array inserts add new keys, without rebuild
+  size_t cap = s.GetFilter().Capacity();
+  size_t added = s.GetFilter().Size();
+  int a[4] = {1, 2, 1500, 1};
+  JNU_UT_CHECK(s.Insert(a, 4));
+  JNU_UT_CHECK(s.Find(1) && s.Find(2) && s.Size() == 502);
+  JNU_UT_EQUAL(s.GetFilter().Capacity(), cap);
+  JNU_UT_EQUAL(s.GetFilter().Size(), added + 2);
+  // and rebuild when saturated
+  std::vector<int> many;
+  for (int i = 0; i < 3000; ++i) {
+    many.push_back(i * 3 + 1);
+  }
+  JNU_UT_CHECK(s.ReplaceInsert(many.data(), many.size()));
+  JNU_UT_CHECK(!s.GetFilter().IsSaturated());
+  JNU_UT_CHECK(s.GetFilter().Capacity() > cap);
+  JNU_UT_CHECK(s.Find(4) && s.Find(8998) && s.Find(2) && !s.Find(3));
+  s.Clear();
+  JNU_UT_CHECK(s.IsEmpty() && !s.Find(1));
+  // Filters of log-structured set levels
+  LSet l;
+  for (int i = 0; i < 2000; ++i) {
+    l.Insert(i * 2);
+  }
+  for (int k = 0; k < 4000; ++k) {
+    int* p = l.Find(k);
+    if (k % 2 == 0) {
+      JNU_UT_CHECK(p && *p == k);
+    } else {
+      JNU_UT_CHECK(!p);
+    }
+  }
+  JNU_UT_CHECK(l.Delete(100) && !l.Find(100));
+}
@@ -0,0 +1,98 @@
+// By JNI
+// Implementation of B+tree tests
+
+#include "jnu_btree_test.h"
+#include <set>
+#include <vector>
+
+using namespace jnu_test;
+
+// Random inserts and deletes compared with reference
+template<typename S>
+void BTreeTest::Check(int n) {
+  S s;
+  std::set<int> ref;  // Reference set
+  unsigned int x = 12345;  // Random keys
+  for (int i = 0; i < n; ++i) {
+    x = x * 1103515245 + 12345;
+    int k = (x >> 8) % (n / 2);
+    bool ins = ref.insert(k).second;
+    typename S::Res r = s.Insert(k);
+    JNU_UT_CHECK(r && r.Inserted() == ins && **r == k);
+  }
+  JNU_UT_EQUAL(s.Size(), ref.size());
+  for (int i = 0; i < n; ++i) {  // Delete about half
+    x = x * 1103515245 + 12345;
+    int k = (x >> 8) % (n / 2);
+    JNU_UT_EQUAL(s.Delete(k), ref.erase(k) > 0);
+  }
+  JNU_UT_EQUAL(s.Size(), ref.size());
+  for (int k = -1; k <= n / 2; ++k) {
+    int* p = s.Find(k);
+    if (ref.count(k)) {
+      JNU_UT_CHECK(p && *p == k);
+    } else {
+      JNU_UT_CHECK(!p);
+    }
+  }
+  std::vector<int> v;  // In order iteration
+  s.ForEach([&v](int& k) { v.push_back(k); });
+  JNU_UT_CHECK(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+  for (int k : ref) {  // Delete all
+    JNU_UT_CHECK(s.Delete(k));
+  }
+  JNU_UT_CHECK(s.IsEmpty() && s.Height() == 0);
+}
+// Main test entry
+void BTreeTest::Test() {
+  Check<TinySet>(3000);
+  Check<SmallSet>(3000);
+  Check<ISet>(20000);
+  // Tree grows in height
+  TinySet t;
+  for (int i = 0; i < 1000; ++i) {
+    t.Insert(i);
+  }
+  JNU_UT_CHECK(t.Height() > 3);
+  JNU_UT_CHECK(t.Locate(500).Found());
+  JNU_UT_CHECK(!t.Locate(-1).Found());
+  JNU_UT_EQUAL(*t.Locate(-1), t.Find(0));
+  // Interface of ArraySetT, hints are ignored
+  TinySet a(100);
+  int u[] = {9, 3, 7, 3, 1};
+  JNU_UT_CHECK(a.Insert(u, 5, 0));
+  JNU_UT_EQUAL(a.Size(), 4);
+  int w[] = {10, 12, 14, 16, 18, 20, 22};
+  JNU_UT_CHECK(a.InsertSorted(w, w + 7));
+  JNU_UT_CHECK(a.Insert(5, a.Find(3)).Inserted());
+  JNU_UT_CHECK(a.Find(12, 0) && a.Locate(14, 0).Found());
+  w[0] = 0;
+  JNU_UT_CHECK(a.ReplaceInject(w, 7));
+  JNU_UT_EQUAL(a.Size(), 13);
+  JNU_UT_CHECK(a.Height() > 1);
+  // Delete runs of elements across leaves
+  int* d = a.Delete(a.Find(3), 6);
+  JNU_UT_CHECK(d && *d == 14);
+  JNU_UT_EQUAL(a.Size(), 7);
+  JNU_UT_CHECK(!a.Find(3) && !a.Find(12) && a.Find(1));
+  JNU_UT_CHECK(!a.Delete(a.Find(22), 1));
+  JNU_UT_CHECK(!a.Delete(a.Find(0), 10));
+  JNU_UT_CHECK(a.IsEmpty() && a.Height() == 0);
+  // Map with replace and inject
+  SMap m;
+  for (int i = 0; i < 200; ++i) {
+    m.Insert(SMap::Type(std::to_string(i), i));
+  }
+  JNU_UT_EQUAL(m.Size(), 200);
+  JNU_UT_CHECK(!m.Insert(SMap::Type("7", -7)).Inserted());
+  JNU_UT_EQUAL(m.Find("7")->Second(), 7);
+  JNU_UT_CHECK(m.ReplaceInsert(SMap::Type("7", -7)).Found());
+  JNU_UT_EQUAL(m.Find("7")->Second(), -7);
+  SMap::Type p("abc", 1);
+  JNU_UT_CHECK(m.Inject(p).Inserted());
+  JNU_UT_EQUAL(m.Find("abc")->Second(), 1);
+  JNU_UT_CHECK(m.Delete("100") && !m.Find("100"));
+  JNU_UT_EQUAL(m.Size(), 200);
+  m.Clear();
+  JNU_UT_CHECK(m.IsEmpty() && !m.Find("7"));
+}
@@ -105,4 +105,32 @@ void CallbackTest::Test() {
   fp.Get().GetObj() = &to;
   fp();
   JNU_UT_CHECK(count == 10);
+  // Test of type erased task
+  jnu::Task t;
+  JNU_UT_CHECK(!t);
+  t();  // Empty task does nothing
+  t = jnu::Task(e);  // Wrap callback
+  JNU_UT_CHECK(t);
+  t();
+  JNU_UT_CHECK(count == 11);
+  // Captured object is moved with task and destroyed once
+  static int alive = 0;  // Number of live captured objects
+  struct Capture {
+    Capture() { ++alive; }
+    Capture(const Capture& c) { ++alive; }
+    ~Capture() { --alive; }
+  };
+  {
+    Capture cap;
+    jnu::Task u([cap]() { ++count; });
+    JNU_UT_EQUAL(alive, 2);
+    jnu::Task v(std::move(u));
+    JNU_UT_CHECK(!u && v);
+    v();
+    JNU_UT_CHECK(count == 12);
+    v.Reset();
+    JNU_UT_EQUAL(alive, 1);
+    v.Set([cap]() { ++count; });
+  }
+  JNU_UT_EQUAL(alive, 0);
 }
@@ -0,0 +1,101 @@
+// By JNI
+// Implementation of compressed sorted set tests
+
+#include "jnu_compressed_array_set_test.h"
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+using namespace jnu_test;
+
+// Compare set with its elements
+template<typename T, typename F>
+void CompressedArraySetTest::Check(size_t n, F key) {
+  std::vector<T> keys;
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back(key(i));
+  }
+  jnu::CompressedArraySet<T> s;
+  JNU_UT_CHECK(s.Assign(keys.data(), keys.size()));
+  JNU_UT_EQUAL(s.Size(), n);
+  JNU_UT_EQUAL(s.Blocks(), n / s.BLOCK);
+  for (size_t i = 0; i < n; ++i) {  // Keys in and between elements
+    JNU_UT_CHECK(s.Find(keys[i]));
+    if (i == 0 || keys[i - 1] + 1 < keys[i]) {
+      JNU_UT_CHECK(!s.Find(keys[i] - 1));
+    }
+  }
+  std::vector<T> v;  // Iterated elements
+  for (auto it = s.Begin(); it; ++it) {
+    v.push_back(*it);
+  }
+  JNU_UT_CHECK(v == keys);
+  v.clear();
+  s.ForEach([&v](T t) { v.push_back(t); });
+  JNU_UT_CHECK(v == keys);
+  for (size_t j = 0; j < n; j += 37) {  // Lower bounds, and following
+    T k = keys[j] - (j && keys[j - 1] + 1 < keys[j]);
+    auto it = s.LowerBound(k);
+    for (size_t m = j; m < JNU_MIN(j + 200, n); ++m, ++it) {
+      JNU_UT_CHECK(it && *it == keys[m]);
+    }
+  }
+  if (n) {
+    T last = keys[n - 1] + 1;  // After last element
+    JNU_UT_EQUAL((bool) s.LowerBound(last), last == 0);
+    JNU_UT_CHECK(s.Append(last) && s.Find(last));
+  }
+}
+// Main test entry
+void CompressedArraySetTest::Test() {
+  // Empty set
+  Check<uint32_t>(0, [](size_t i) { return i; });
+  jnu::CompressedArraySet<uint32_t> e;
+  JNU_UT_CHECK(!e.Find(0));
+  JNU_UT_CHECK(!e.Begin());
+  JNU_UT_CHECK(!e.LowerBound(0));
+  // Elements must be appended in order
+  JNU_UT_CHECK(e.Append(5));
+  JNU_UT_CHECK(!e.Append(5));
+  JNU_UT_CHECK(!e.Append(3));
+  JNU_UT_EQUAL(e.Back(), 5);
+  JNU_UT_EQUAL(e.Size(), 1);
+  // Dense elements take few bits
+  Check<uint32_t>(100000, [](size_t i) {
+    return (uint32_t) (i + 1000); });
+  jnu::CompressedArraySet<uint32_t> d;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    d.Append(i * 3);
+  }
+  JNU_UT_CHECK(d.Bytes() < 100000 * sizeof(uint32_t) / 4);
+  // Partial last block, gaps of all widths
+  Check<uint32_t>(1000, [](size_t i) {
+    return (uint32_t) (i * i * 4001 + i); });
+  Check<uint32_t>(300, [](size_t i) {
+    return (uint32_t) (i * 14000000); });
+  Check<uint32_t>(129, [](size_t i) {
+    return (uint32_t) (i ? UINT32_MAX - 129 + i : 0); });
+  // Outliers are patched exceptions
+  Check<uint32_t>(20000, [](size_t i) {
+    return (uint32_t) (i * 5 + (i / 50) * 1000000); });
+  // 64 bit elements
+  Check<uint64_t>(20000, [](size_t i) {
+    return (uint64_t) i * i * i * 10007 + (i % 7); });
+  Check<uint64_t>(5000, [](size_t i) {
+    return ((uint64_t) (i / 100) << 50) + i * 3; });
+  Check<uint64_t>(300, [](size_t i) {
+    return (uint64_t) (i ? UINT64_MAX - 300 + i : 0); });
+  // Timestamps in milliseconds take a third of memory
+  jnu::CompressedArraySet<uint64_t> t;
+  std::vector<uint64_t> ts;
+  for (uint64_t i = 0; i < 100000; ++i) {
+    ts.push_back(1700000000000ULL + i * 1000 + (i * 7919) % 997);
+  }
+  JNU_UT_CHECK(t.Assign(ts.data(), ts.size()));
+  JNU_UT_CHECK(t.Bytes() < ts.size() * sizeof(uint64_t) / 3);
+  JNU_UT_CHECK(t.Find(ts[54321]));
+  JNU_UT_CHECK(!t.Find(ts[54321] + 1));
+  t.Free();
+  JNU_UT_CHECK(t.IsEmpty());
+  JNU_UT_CHECK(!t.Find(ts[0]));
+}
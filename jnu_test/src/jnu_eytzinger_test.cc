@@ -0,0 +1,74 @@
+// By JNI
+// Implementation of Eytzinger layout search index tests
+
+#include "jnu_eytzinger_test.h"
+
+using namespace jnu_test;
+
+// Main test entry
+void EytzingerTest::Test() {
+  ISet s;
+  jnu::EytzingerIndex<ISet> idx(s);
+  // Empty set
+  JNU_UT_CHECK(idx.Rebuild());
+  JNU_UT_CHECK(!idx.Find(0));
+  JNU_UT_CHECK(!idx.Locate(0).Found());
+  // Same results as set for keys in and between elements,
+  // for all tree shapes of small sizes
+  for (int n = 1; n < 70; ++n) {
+    s.Insert(n * 2);
+    JNU_UT_CHECK(idx.Rebuild());
+    JNU_UT_CHECK(!idx.IsStale());
+    for (int k = 0; k <= n * 2 + 2; ++k) {
+      ISet::Res a = idx.Locate(k);
+      ISet::Res b = s.Locate(k);
+      JNU_UT_EQUAL(*a, *b);
+      JNU_UT_EQUAL(a.Found(), b.Found());
+    }
+  }
+  // Stale index still returns right results
+  s.Insert(7);
+  s.Delete(s.Begin(), 3);
+  JNU_UT_CHECK(idx.IsStale());
+  JNU_UT_EQUAL(idx.Find(7), s.Find(7));
+  JNU_UT_CHECK(!idx.Find(2));
+  // Content changed without size change
+  s.Delete(s.Find(7), 1);
+  s.Insert(9);
+  JNU_UT_CHECK(idx.Rebuild());
+  s.Delete(s.Find(9), 1);
+  s.Insert(11);
+  JNU_UT_CHECK(!idx.Find(9));
+  JNU_UT_EQUAL(idx.Find(11), s.Find(11));
+  // Incremental rebuild, old index serves until complete
+  for (int i = 1000; i < 2000; ++i) {
+    s.Insert(i);
+  }
+  int steps = 0;  // Number of steps
+  while (!idx.Rebuild(100)) {
+    JNU_UT_CHECK(idx.IsBuilding());
+    ++steps;
+  }
+  JNU_UT_CHECK(!idx.IsBuilding() && !idx.IsStale());
+  JNU_UT_EQUAL(steps, (int) (s.Size() / 100));
+  for (int k = 0; k < 2100; ++k) {
+    JNU_UT_EQUAL(idx.Find(k), s.Find(k));
+  }
+  // Rebuild restarts if set size changes
+  JNU_UT_CHECK(!idx.Rebuild(10));
+  s.Insert(5000);
+  JNU_UT_CHECK(idx.Rebuild(s.Size()));
+  JNU_UT_EQUAL(idx.Find(5000), s.Find(5000));
+  // Object keys
+  SMap m;
+  const char* keys[] = {"pear", "apple", "fig", "kiwi", "lime"};
+  for (int i = 0; i < 5; ++i) {
+    m.Insert(SArr::Type(keys[i], i));
+  }
+  jnu::EytzingerIndex<SMap> sidx(m);
+  JNU_UT_CHECK(sidx.Rebuild());
+  JNU_UT_EQUAL(sidx.Find("fig")->Second(), 2);
+  JNU_UT_EQUAL(sidx.Find("pear")->Second(), 0);
+  JNU_UT_CHECK(!sidx.Find("grape"));
+  JNU_UT_EQUAL(*sidx.Locate("grape"), m.Begin() + 2);
+}
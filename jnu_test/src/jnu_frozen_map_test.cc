@@ -0,0 +1,62 @@
+// By JNI
+// Implementation of perfect hash index tests
+
+#include "jnu_frozen_map_test.h"
+
+using namespace jnu_test;
+
+// Freeze maps of n keys and compare lookups with map
+void FrozenMapTest::Check(size_t n) {
+  LMap m;
+  for (long i = 0; i < (long) n; ++i) {
+    m.Insert(LArr::Type(i * 7 - 1000, std::to_string(i)));
+  }
+  jnu::FrozenMap<LMap> f(m);
+  JNU_UT_CHECK(f.Freeze() && !f.IsStale());
+  for (long i = 0; i < (long) n; ++i) {
+    JNU_UT_EQUAL(f.Find(i * 7 - 1000), m.Begin() + i);
+    JNU_UT_CHECK(!f.Find(i * 7 - 999));
+  }
+}
+// Main test entry
+void FrozenMapTest::Test() {
+  // Small maps, the table is the set size
+  for (size_t n = 0; n < 20; ++n) {
+    Check(n);
+  }
+  // Large maps
+  Check(1000);
+  Check(100000);
+  // String keys
+  SMap s;
+  for (int i = 0; i < 5000; ++i) {
+    s.Insert(SArr::Type("key" + std::to_string(i * 3), i));
+  }
+  jnu::FrozenMap<SMap> fs(s);
+  JNU_UT_CHECK(fs.Freeze());
+  JNU_UT_CHECK(fs.Buckets() > 0 && fs.Buckets() < s.Size());
+  for (int i = 0; i < 5000; ++i) {
+    SArr::Type* p = fs.Find("key" + std::to_string(i * 3));
+    JNU_UT_CHECK(p && p->Second() == i);
+    JNU_UT_CHECK(!fs.Find("key" + std::to_string(i * 3 + 1)));
+  }
+  // Values stay sorted for ranges
+  JNU_UT_EQUAL(fs.Set().Begin()->First(), "key0");
+  // Stale index searches the map
+  s.Insert(SArr::Type("key1", -1));
+  JNU_UT_CHECK(fs.IsStale());
+  JNU_UT_EQUAL(fs.Find("key1")->Second(), -1);
+  JNU_UT_EQUAL(fs.Find("key3")->Second(), 1);
+  JNU_UT_CHECK(fs.Freeze());
+  JNU_UT_EQUAL(fs.Find("key1")->Second(), -1);
+  // Keys with equal hashes can not be frozen, map is searched
+  LMap m;
+  for (long i = 0; i < 100; ++i) {
+    m.Insert(LArr::Type(i, std::to_string(i)));
+  }
+  jnu::FrozenMap<LMap, BadHash> fb(m);
+  JNU_UT_CHECK(!fb.Freeze());
+  JNU_UT_CHECK(fb.IsStale());
+  JNU_UT_EQUAL(fb.Find(42)->Second(), "42");
+  JNU_UT_CHECK(!fb.Find(100));
+}
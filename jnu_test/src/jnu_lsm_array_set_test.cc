@@ -0,0 +1,170 @@
+// By JNI
+// Implementation of log-structured sorted set tests
+
+#include "jnu_lsm_array_set_test.h"
+#include <vector>
+
+using namespace jnu_test;
+
+// Number of key comparisons
+static size_t compares = 0;
+// Less comparison, counted
+static bool CountLess(const int& a, const int& b) {
+  ++compares;
+  return a < b;
+}
+
+// Main test entry
+void LsmArraySetTest::Test() {
+  ISet s;
+  JNU_UT_CHECK(s.IsEmpty());
+  JNU_UT_CHECK(!s.Find(0));
+  JNU_UT_CHECK(!s.Delete(0));
+  JNU_UT_CHECK(s.Begin() == s.End());
+  // Keys spread over buffer and levels
+  for (int i = 0; i < 1000; ++i) {
+    int k = (i * 7919) % 1000;  // All keys of [0, 1000)
+    JNU_UT_CHECK(s.Insert(k).Inserted());
+  }
+  JNU_UT_EQUAL(s.Size(), 1000);
+  JNU_UT_CHECK(s.Levels() > 1);
+  for (int k = -10; k < 1010; ++k) {
+    int* p = s.Find(k);
+    if (k >= 0 && k < 1000) {
+      JNU_UT_CHECK(p && *p == k);
+    } else {
+      JNU_UT_CHECK(!p);
+    }
+  }
+  // Existing keys are not inserted again
+  ISet::Res r = s.Insert(500);
+  JNU_UT_CHECK(r && r.Found() && **r == 500);
+  JNU_UT_EQUAL(s.Size(), 1000);
+  // Ordered iteration over all runs
+  std::vector<int> v;
+  s.ForEach([&v](const int& k) { v.push_back(k); });
+  JNU_UT_EQUAL(v.size(), 1000);
+  for (size_t i = 0; i < v.size(); ++i) {
+    JNU_UT_EQUAL(v[i], (int) i);
+  }
+  // Delete from buffer and levels
+  for (int k = 0; k < 1000; k += 2) {
+    JNU_UT_CHECK(s.Delete(k));
+  }
+  JNU_UT_EQUAL(s.Size(), 500);
+  JNU_UT_CHECK(!s.Find(100) && s.Find(101));
+  JNU_UT_CHECK(!s.Delete(100));
+  // Compact into one level
+  JNU_UT_CHECK(s.Compact());
+  v.clear();
+  s.ForEach([&v](const int& k) { v.push_back(k); });
+  JNU_UT_CHECK(v.size() == 500 && v[0] == 1 && v[499] == 999);
+  s.Clear();
+  JNU_UT_CHECK(s.IsEmpty() && !s.Find(101) && s.Levels() == 0);
+  // Interface of ArraySetT, hints are ignored
+  ISet a(100);
+  int t[] = {5, 3, 9, 3, 1};
+  JNU_UT_CHECK(a.Insert(t, 5));
+  JNU_UT_EQUAL(a.Size(), 4);
+  JNU_UT_CHECK(a.Insert(7, a.End()).Inserted());
+  int u[] = {2, 4, 6, 8, 10, 12, 14, 16, 18};
+  JNU_UT_CHECK(a.InsertSorted(u, u + 9));
+  JNU_UT_CHECK(a.Inject(u, 9, a.Begin()));
+  JNU_UT_EQUAL(a.Size(), 14);
+  JNU_UT_CHECK(a.Find(12, a.Begin()) && !a.Find(11));
+  // Merged view of all runs
+  JNU_UT_EQUAL(a.End() - a.Begin(), 14);
+  JNU_UT_EQUAL(a.Levels(), 1);
+  for (int* p = a.Begin(); p + 1 < a.End(); ++p) {
+    JNU_UT_CHECK(p[0] < p[1]);
+  }
+  JNU_UT_EQUAL(a[0], 1);
+  JNU_UT_EQUAL(*a.RBegin(), 18);
+  JNU_UT_EQUAL(*a.LowerBound(11), 12);
+  JNU_UT_EQUAL(*a.UpperBound(12), 14);
+  JNU_UT_CHECK(a.Locate(11).Inserted() && **a.Locate(12) == 12);
+  JNU_UT_EQUAL(a.EqualRange(9).Size(), 1);
+  ISet::View w = a.Range(3, 8);
+  JNU_UT_CHECK(w.Size() == 5 && w[0] == 3 && w[4] == 7);
+  JNU_UT_EQUAL(a.CountRange(0, 100), 14);
+  // Writes after the view go to the buffer again
+  JNU_UT_CHECK(a.Insert(0).Inserted());
+  JNU_UT_EQUAL(*a.Begin(), 0);
+  // Delete elements of merged run and of buffer
+  int* p = a.Delete(a.LowerBound(3), 3);
+  JNU_UT_EQUAL(*p, 6);
+  JNU_UT_CHECK(!a.Find(3) && !a.Find(5) && a.Find(6));
+  JNU_UT_CHECK(a.Insert(11).Inserted());
+  JNU_UT_CHECK(a.Find(11));
+  a.Delete(a.Find(11), 1);
+  JNU_UT_CHECK(!a.Find(11));
+  JNU_UT_EQUAL(a.Size(), 12);
+  // Replace values of map
+  PMap m;
+  for (int i = 0; i < 100; ++i) {
+    m.Insert(PArr::Type(i, "a"));
+  }
+  for (int i = 0; i < 100; i += 3) {
+    JNU_UT_CHECK(m.ReplaceInsert(PArr::Type(i, "b")).Found());
+  }
+  JNU_UT_CHECK(!m.Insert(PArr::Type(1, "c")).Inserted());
+  JNU_UT_EQUAL(m.Size(), 100);
+  JNU_UT_EQUAL(m.Find(0)->Second(), "b");
+  JNU_UT_EQUAL(m.Find(1)->Second(), "a");
+  JNU_UT_EQUAL(m.Find(99)->Second(), "b");
+  PArr::Type q(200, "d");
+  JNU_UT_CHECK(m.Inject(q).Inserted());
+  JNU_UT_EQUAL(m.Find(200)->Second(), "d");
+  // Bloom filters of levels, no false negatives
+  BSet b;
+  for (int i = 0; i < 1000; ++i) {
+    JNU_UT_CHECK(b.Insert(i * 2).Inserted());
+  }
+  JNU_UT_CHECK(b.Levels() > 1);
+  for (int k = 0; k < 2000; ++k) {
+    int* f = b.Find(k);
+    if (k % 2 == 0) {
+      JNU_UT_CHECK(f && *f == k);
+    } else {
+      JNU_UT_CHECK(!f);
+    }
+  }
+  JNU_UT_CHECK(b.Delete(10) && !b.Find(10));
+  JNU_UT_CHECK(b.Compact());
+  JNU_UT_CHECK(b.Find(12) && !b.Find(13));
+  JNU_UT_EQUAL(b.Size(), 999);
+  // Misses skip levels rejected by filters
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> CArr;
+  jnu::LsmArraySet<CArr, CountLess, 8> c;
+  jnu::LsmArraySet<CArr, CountLess, 8, jnu::BloomFilter<int>> cb;
+  for (int i = 0; i < 1000; ++i) {
+    c.Insert(i * 2);
+    cb.Insert(i * 2);
+  }
+  compares = 0;
+  for (int k = 1; k < 2000; k += 2) {
+    c.Find(k);
+  }
+  size_t n = compares;  // Comparisons of unfiltered misses
+  compares = 0;
+  for (int k = 1; k < 2000; k += 2) {
+    cb.Find(k);
+  }
+  JNU_UT_CHECK(compares * 2 < n);
+  // Reads of compacted set do not merge again
+  JNU_UT_CHECK(cb.Compact());
+  size_t depth = cb.Levels();  // Levels after compaction
+  compares = 0;
+  for (int i = 0; i < 10; ++i) {
+    JNU_UT_EQUAL(cb[i], i * 2);
+  }
+  JNU_UT_EQUAL(*cb.LowerBound(7), 8);
+  JNU_UT_CHECK(compares < 32);  // Comparisons of LowerBound only
+  JNU_UT_EQUAL(cb.Levels(), depth);
+  JNU_UT_CHECK(cb.Find(1998) && !cb.Find(1999));
+  // Emptied levels are trimmed
+  cb.Delete(cb.Begin(), cb.Size());
+  JNU_UT_CHECK(cb.Compact());
+  JNU_UT_EQUAL(cb.Levels(), 0);
+  JNU_UT_CHECK(cb.Begin() == cb.End());
+}
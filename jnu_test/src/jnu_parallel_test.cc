@@ -0,0 +1,73 @@
+// By JNI
+// Implementation of parallel algorithm tests
+
+#include "jnu_parallel_test.h"
+
+using namespace jnu_test;
+
+// Main test entry
+void ParallelTest::Test() {
+  const static int ITEMS = 100000;  // Number of items
+  const static size_t GRAIN = 1000;  // Small grain to force chunks
+  jnu::ThreadPool p(3, 256);
+  Arr a;
+  JNU_UT_CHECK(a.Expand(a.Begin(), ITEMS));
+  for (int i = 0; i < ITEMS; ++i) {
+    a[i] = i;
+  }
+  // For each on array
+  jnu::parallel::ForEach(p, a, [](int& v) { v = v * 2 + 1; }, GRAIN);
+  for (int i = 0; i < ITEMS; ++i) {
+    JNU_UT_EQUAL(a[i], i * 2 + 1);
+  }
+  // Transform into array of other type, output is resized
+  LArr l;
+  JNU_UT_CHECK(jnu::parallel::Transform(p, a, l, [](const int& v) {
+    return (long) v * v;
+  }, GRAIN));
+  JNU_UT_EQUAL(l.Size(), ITEMS);
+  for (int i = 0; i < ITEMS; ++i) {
+    JNU_UT_EQUAL(l[i], (long) a[i] * a[i]);
+  }
+  // Reduce, large and small input
+  auto add = [](long x, long y) { return x + y; };
+  long sum = jnu::parallel::Reduce(p, a, 0L, add, GRAIN);
+  JNU_UT_EQUAL(sum, (long) ITEMS * ITEMS);
+  sum = jnu::parallel::Reduce(p, a.Begin(), a.Begin() + 10, 5L, add);
+  JNU_UT_EQUAL(sum, 105);
+  // Reduce keeps order of non-commutative operator
+  auto keep = [](long x, long y) { return x * 0 + y; };  // Last item
+  JNU_UT_EQUAL(jnu::parallel::Reduce(p, a, -1L, keep, GRAIN),
+               a[ITEMS - 1]);
+  // Inclusive scan into other array and in place
+  jnu::parallel::ForEach(p, a, [](int& v) { v = v % 7; }, GRAIN);
+  Arr s;
+  auto iadd = [](int x, int y) { return x + y; };
+  JNU_UT_CHECK(jnu::parallel::InclusiveScan(p, a, s, iadd, GRAIN));
+  JNU_UT_EQUAL(s.Size(), ITEMS);
+  jnu::parallel::InclusiveScan(p, a.Begin(), a.End(), a.Begin(),
+                               iadd, GRAIN);
+  int acc = 0;  // Serial scan
+  for (int i = 0; i < ITEMS; ++i) {
+    acc += (i * 2 + 1) % 7;
+    JNU_UT_EQUAL(s[i], acc);
+    JNU_UT_EQUAL(a[i], acc);
+  }
+  // Stable sort, equal keys keep input order
+  LArr k;
+  JNU_UT_CHECK(k.Expand(k.Begin(), ITEMS));
+  for (int i = 0; i < ITEMS; ++i) {
+    k[i] = (long) (i * 7919 % 1000) * ITEMS + i;  // Key and order
+  }
+  jnu::parallel::Sort(p, k.Begin(), k.End(), [](long x, long y) {
+    return x / ITEMS < y / ITEMS;  // Compare key only
+  }, GRAIN);
+  for (int i = 1; i < ITEMS; ++i) {
+    JNU_UT_CHECK(k[i - 1] < k[i]);  // Key then order ascending
+  }
+  // Empty and serial ranges
+  Arr e;
+  JNU_UT_EQUAL(jnu::parallel::Reduce(p, e, 3L, add), 3);
+  JNU_UT_CHECK(jnu::parallel::InclusiveScan(p, e, s, iadd));
+  JNU_UT_CHECK(s.IsEmpty());
+}
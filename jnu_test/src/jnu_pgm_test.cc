@@ -0,0 +1,103 @@
+// By JNI
+// Implementation of learned search index tests
+
+#include "jnu_pgm_test.h"
+#include <stdint.h>
+#include <vector>
+
+using namespace jnu_test;
+
+// Number of key comparisons
+static size_t compares = 0;
+// Less comparison, counted
+static bool CountLess(const int& a, const int& b) {
+  ++compares;
+  return a < b;
+}
+
+// Compare index with set for keys in and between elements
+template<typename K, size_t EPS, typename F>
+void PgmTest::Check(size_t n, F key) {
+  typedef jnu::DArray<K, jnu::ARR_MEM_ALLOC, 64> KArr;
+  typedef jnu::ArraySet<KArr> KSet;
+  KSet s;
+  std::vector<K> keys;
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back(key(i));
+  }
+  s.InsertSorted(keys.data(), keys.size());
+  jnu::PgmIndex<KSet, EPS> idx(s);
+  JNU_UT_CHECK(idx.Rebuild());
+  for (size_t i = 0; i < n; ++i) {
+    for (K k : {keys[i], (K) (keys[i] - 1), (K) (keys[i] + 1)}) {
+      typename KSet::Res a = idx.Locate(k);
+      typename KSet::Res b = s.Locate(k);
+      JNU_UT_CHECK(*a == *b && a.Found() == b.Found());
+    }
+  }
+}
+// Main test entry
+void PgmTest::Test() {
+  // Empty set
+  Check<int, 4>(0, [](size_t i) { return (int) i; });
+  // Linear keys need one segment
+  typedef jnu::DArray<int, jnu::ARR_MEM_ALLOC, 64> IArr;
+  typedef jnu::ArraySet<IArr> ISet;
+  ISet s;
+  for (int i = 0; i < 10000; ++i) {
+    s.Insert(i * 3 + 100);
+  }
+  jnu::PgmIndex<ISet> idx(s);
+  JNU_UT_CHECK(idx.Rebuild());
+  JNU_UT_EQUAL(idx.Segments(), 1);
+  JNU_UT_EQUAL(idx.Levels(), 1);
+  JNU_UT_EQUAL(idx.Find(103), s.Begin() + 1);
+  JNU_UT_CHECK(!idx.Find(104));
+  JNU_UT_EQUAL(*idx.Locate(0), s.Begin());
+  JNU_UT_EQUAL(*idx.Locate(1000000), s.End());
+  // Curved and irregular keys need levels of segments
+  Check<int, 4>(5000, [](size_t i) {
+    return (int) (i * i) - 3000000; });
+  Check<int64_t, 8>(20000, [](size_t i) {
+    return (int64_t) (i * i * i) + INT64_MIN + 1; });
+  Check<uint32_t, 2>(20000, [](size_t i) {
+    return (uint32_t) (i * 97 + (i * 7919) % 89 +
+                       (i / 1000) * 500000); });
+  Check<uint64_t, 16>(20000, [](size_t i) {
+    return ((uint64_t) (i / 100) << 40) + i * i; });
+  Check<short, 1>(1000, [](size_t i) {
+    return (short) (i * 7 - 3500); });
+  // Misses between segments are found in the search window,
+  // only validation compares keys, the set is not searched
+  typedef jnu::ArraySet<IArr, CountLess> CSet;
+  CSet c;
+  for (int i = 0; i < 10; ++i) {  // Clusters far apart
+    for (int j = 0; j < 1000; ++j) {
+      c.Insert(i * 1000000 + j, c.End() - 1);
+    }
+  }
+  jnu::PgmIndex<CSet> cidx(c);
+  JNU_UT_CHECK(cidx.Rebuild());
+  JNU_UT_CHECK(cidx.Segments() > 10);
+  compares = 0;
+  for (int i = 0; i < 10; ++i) {
+    JNU_UT_EQUAL(*cidx.Locate(i * 1000000 + 500000),
+                 c.Begin() + (i + 1) * 1000);
+  }
+  JNU_UT_CHECK(compares <= 10 * 3);
+  // Stale index still returns right results
+  s.Insert(101);
+  JNU_UT_CHECK(idx.IsStale());
+  JNU_UT_EQUAL(idx.Find(101), s.Begin() + 1);
+  JNU_UT_EQUAL(idx.Find(103), s.Begin() + 2);
+  // Map with integral keys
+  PMap m;
+  for (long i = 0; i < 1000; ++i) {
+    m.Insert(PArr::Type(i * i, std::to_string(i)));
+  }
+  jnu::PgmIndex<PMap, 8> midx(m);
+  JNU_UT_CHECK(midx.Rebuild());
+  JNU_UT_CHECK(midx.Levels() > 1);
+  JNU_UT_EQUAL(midx.Find(900)->Second(), "30");
+  JNU_UT_CHECK(!midx.Find(901));
+}
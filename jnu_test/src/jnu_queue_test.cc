@@ -0,0 +1,236 @@
+// By JNI
+// Implementation of bounded concurrent queue tests
+
+#include "jnu_queue_test.h"
+#include <thread>
+#include <vector>
+
+using namespace jnu_test;
+
+// Test of single producer single consumer ring
+void SpscRingTest::Test() {
+  Ring r;
+  int in[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  int out[12] = {0};
+  JNU_UT_EQUAL(r.Capacity(), 8);
+  JNU_UT_CHECK(r.IsEmpty());
+  JNU_UT_CHECK(!r.Pop(out[0]));
+  // Fill up, only capacity items are accepted
+  JNU_UT_EQUAL(r.PushBatch(in, 12), 8);
+  JNU_UT_CHECK(!r.Push(in[8]));
+  JNU_UT_EQUAL(r.Size(), 8);
+  JNU_UT_EQUAL(r.PopBatch(out, 5), 5);
+  JNU_UT_EQUAL(out[0], 0);
+  JNU_UT_EQUAL(out[4], 4);
+  // Push across the wrap point
+  JNU_UT_EQUAL(r.PushBatch(in + 8, 4), 4);
+  JNU_UT_CHECK(r.Push(in[0]));
+  JNU_UT_EQUAL(r.Size(), 8);
+  // Pop across the wrap point
+  JNU_UT_EQUAL(r.PopBatch(out, 12), 8);
+  for (int i = 0; i < 7; ++i) {
+    JNU_UT_EQUAL(out[i], i + 5);
+  }
+  JNU_UT_EQUAL(out[7], 0);
+  JNU_UT_CHECK(r.IsEmpty());
+  // Object ring, capacity rounded up to power of 2
+  SRing s(5);
+  JNU_UT_EQUAL(s.Capacity(), 8);
+  std::string str[3] = {"alpha", "beta", "gamma"};
+  JNU_UT_CHECK(s.Push(str[0]));
+  JNU_UT_EQUAL(str[0], "alpha");  // Copied
+  JNU_UT_EQUAL(s.InjectBatch(str + 1, 2), 2);
+  std::string res[3];
+  JNU_UT_EQUAL(s.PopBatch(res, 3), 3);
+  JNU_UT_EQUAL(res[0], "alpha");
+  JNU_UT_EQUAL(res[1], "beta");
+  JNU_UT_EQUAL(res[2], "gamma");
+  // Concurrent transfer in batches, order must be kept
+  const static int ITEMS = 200000;  // Items to transfer
+  const static int BATCH = 5;  // Batch size
+  jnu::DSpscRing<int, jnu::ARR_MEM_ALLOC> c(64);
+  std::thread p([&c]() {
+    int buf[BATCH];
+    for (int i = 0; i < ITEMS;) {
+      int n = JNU_MIN(BATCH, ITEMS - i);
+      for (int j = 0; j < n; ++j) {
+        buf[j] = i + j;
+      }
+      int k = 0;
+      while (k < n) {  // Retry until all are pushed
+        int m = c.PushBatch(buf + k, n - k);
+        if (!m) {  // Full, let consumer run
+          std::this_thread::yield();
+        }
+        k += m;
+      }
+      i += n;
+    }
+  });
+  int next = 0;  // Next expected item
+  bool ordered = true;  // Order check
+  int buf[BATCH * 2];
+  while (next < ITEMS) {
+    size_t n = c.PopBatch(buf, BATCH * 2);
+    if (!n) {  // Empty, let producer run
+      std::this_thread::yield();
+    }
+    for (size_t j = 0; j < n; ++j) {
+      ordered = ordered && buf[j] == next;
+      ++next;
+    }
+  }
+  p.join();
+  JNU_UT_CHECK(ordered);
+  JNU_UT_EQUAL(next, ITEMS);
+  JNU_UT_CHECK(c.IsEmpty());
+}
+// Test of multiple producers multiple consumers queue
+void MpmcQueueTest::Test() {
+  Queue q(3);
+  int v = 0;
+  JNU_UT_EQUAL(q.Capacity(), 4);
+  JNU_UT_CHECK(q.IsEmpty());
+  JNU_UT_CHECK(!q.Pop(v));
+  // Fill up and drain across several laps
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      JNU_UT_CHECK(q.Push(lap * 4 + i));
+    }
+    JNU_UT_CHECK(!q.Push(100));
+    JNU_UT_EQUAL(q.Size(), 4);
+    for (int i = 0; i < 4; ++i) {
+      JNU_UT_CHECK(q.Pop(v));
+      JNU_UT_EQUAL(v, lap * 4 + i);
+    }
+    JNU_UT_CHECK(!q.Pop(v));
+  }
+  // Object queue through custom memory manager
+  {
+    SQueue s(2, &jnu::memory::MM_CUSTOM_DEF);
+    std::string a = "alpha", b = "beta", r;
+    JNU_UT_CHECK(s.Push(a));
+    JNU_UT_EQUAL(a, "alpha");  // Copied
+    JNU_UT_CHECK(s.Inject(b));
+    JNU_UT_CHECK(s.Pop(r));
+    JNU_UT_EQUAL(r, "alpha");
+    JNU_UT_CHECK(s.Pop(r));
+    JNU_UT_EQUAL(r, "beta");
+  }
+  // Concurrent producers and consumers
+  // Each consumer must see items of one producer in order
+  const static int PRODUCERS = 4;  // Number of producers
+  const static int CONSUMERS = 4;  // Number of consumers
+  const static int ITEMS = 20000;  // Items per producer
+  Queue c(64);
+  jnu::atomic::Base<int> done(0);  // Consumed items
+  jnu::atomic::Base<long> sum(0);  // Sum of consumed items
+  jnu::atomic::Base<int> disorder(0);  // Order violations
+  std::thread t[PRODUCERS + CONSUMERS];
+  for (int i = 0; i < PRODUCERS; ++i) {
+    t[i] = std::thread([&c, i]() {
+      for (int j = 0; j < ITEMS; ++j) {
+        while (!c.Push(i * ITEMS + j)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int i = 0; i < CONSUMERS; ++i) {
+    t[PRODUCERS + i] = std::thread([&]() {
+      int last[PRODUCERS];  // Last item seen per producer
+      for (int j = 0; j < PRODUCERS; ++j) {
+        last[j] = -1;
+      }
+      int val = 0;
+      while (done.Load() < PRODUCERS * ITEMS) {
+        if (!c.Pop(val)) {
+          std::this_thread::yield();
+          continue;
+        }
+        int p = val / ITEMS;  // Producer of item
+        if (val % ITEMS <= last[p]) {
+          disorder.AddFetch(1);
+        }
+        last[p] = val % ITEMS;
+        sum.AddFetch(val);
+        done.AddFetch(1);
+      }
+    });
+  }
+  for (int i = 0; i < PRODUCERS + CONSUMERS; ++i) {
+    t[i].join();
+  }
+  long n = PRODUCERS * ITEMS;  // Total items
+  JNU_UT_EQUAL(done.Load(), n);
+  JNU_UT_EQUAL(sum.Load(), n * (n - 1) / 2);
+  JNU_UT_EQUAL(disorder.Load(), 0);
+  JNU_UT_CHECK(c.IsEmpty());
+}
+// Test of work stealing deque
+void WorkStealDequeTest::Test() {
+  Deque d(4);
+  int v[5] = {0, 1, 2, 3, 4};
+  JNU_UT_EQUAL(d.Capacity(), 4);
+  JNU_UT_CHECK(d.IsEmpty());
+  JNU_UT_EQUAL(d.Pop(), NULL);
+  JNU_UT_EQUAL(d.Steal(), NULL);
+  for (int i = 0; i < 4; ++i) {
+    JNU_UT_CHECK(d.Push(v + i));
+  }
+  JNU_UT_CHECK(!d.Push(v + 4));  // Full
+  JNU_UT_EQUAL(d.Pop(), v + 3);  // Owner takes newest
+  JNU_UT_EQUAL(d.Steal(), v);  // Thief takes oldest
+  JNU_UT_EQUAL(d.Size(), 2);
+  JNU_UT_CHECK(d.Push(v + 4));
+  JNU_UT_EQUAL(d.Pop(), v + 4);
+  JNU_UT_EQUAL(d.Pop(), v + 2);
+  JNU_UT_EQUAL(d.Pop(), v + 1);
+  JNU_UT_EQUAL(d.Pop(), NULL);
+  // Owner pushes and pops while thieves steal,
+  // every item must be taken exactly once
+  const static int ITEMS = 100000;  // Items to push
+  const static int THIEVES = 3;  // Number of thieves
+  Deque c(256);
+  std::vector<int> items(ITEMS, 0);  // Times each item is taken
+  jnu::atomic::Base<bool> stop(false);
+  std::thread t[THIEVES];
+  for (int i = 0; i < THIEVES; ++i) {
+    t[i] = std::thread([&]() {
+      while (!stop.Load()) {
+        if (int* p = c.Steal()) {
+          ++*p;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < ITEMS; ++i) {
+    while (!c.Push(&items[i])) {  // Full, take one back
+      if (int* p = c.Pop()) {
+        ++*p;
+      }
+    }
+    if (i % 3 == 0) {
+      if (int* p = c.Pop()) {
+        ++*p;
+      }
+    }
+  }
+  while (int* p = c.Pop()) {
+    ++*p;
+  }
+  stop = true;
+  for (int i = 0; i < THIEVES; ++i) {
+    t[i].join();
+  }
+  for (int i = 0; i < ITEMS; ++i) {  // Taken exactly once
+    JNU_UT_EQUAL(items[i], 1);
+  }
+  JNU_UT_CHECK(c.IsEmpty());
+}
+// Test of bounded queues
+void QueueTest::Test() {
+  Run<SpscRingTest>("spsc ring");  // Single producer single consumer
+  Run<MpmcQueueTest>("mpmc queue");  // Multiple producers multiple consumers
+  Run<WorkStealDequeTest>("work steal deque");  // Chase-Lev deque
+}
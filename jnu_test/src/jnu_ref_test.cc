@@ -0,0 +1,116 @@
+// By JNI
+// Test cases of intrusive reference counting
+
+#include "jnu_ref_test.h"
+#include <thread>
+
+using namespace jnu_test;
+
+// Number of destroyed test objects
+static int destroyed = 0;
+// Test object with atomic reference count
+struct RefObj : public jnu::RefCounted {
+  RefObj(int val)
+    : m_val (val) {
+  }
+  ~RefObj() {
+    ++destroyed;
+  }
+  int m_val;
+};
+// Test object with biased reference count
+struct BiasedObj : public jnu::BiasedRefCounted {
+  BiasedObj(int val)
+    : m_val (val) {
+  }
+  ~BiasedObj() {
+    ++destroyed;
+  }
+  int m_val;
+};
+// Test of atomic reference count
+void RefTest::TestRef() {
+  destroyed = 0;
+  jnu::Ref<RefObj> a;
+  JNU_UT_CHECK(!a);
+  JNU_UT_CHECK(a.New(&jnu::memory::MM_BUILDIN, 8, 5));
+  JNU_UT_EQUAL(a->m_val, 5);
+  JNU_UT_EQUAL(a->RefCount(), 1);
+  jnu::Ref<RefObj> b = a;  // Copy
+  JNU_UT_EQUAL(a->RefCount(), 2);
+  jnu::Ref<RefObj> c = std::move(b);  // Move
+  JNU_UT_CHECK(!b && c == a);
+  JNU_UT_EQUAL(a->RefCount(), 2);
+  // Copy and release on other threads
+  std::thread t[4];
+  for (int i = 0; i < 4; ++i) {
+    t[i] = std::thread([c]() {
+      for (int j = 0; j < 1000; ++j) {
+        jnu::Ref<RefObj> d(c);
+      }
+    });
+  }
+  for (int i = 0; i < 4; ++i) {
+    t[i].join();
+  }
+  JNU_UT_EQUAL(a->RefCount(), 2);
+  a.Reset();
+  JNU_UT_EQUAL(destroyed, 0);
+  c = a;  // Release last reference
+  JNU_UT_EQUAL(destroyed, 1);
+  // Objects not created by New are not freed
+  RefObj s(1);
+  {
+    jnu::Ref<RefObj> r(&s);
+    JNU_UT_EQUAL(s.RefCount(), 1);
+  }
+  JNU_UT_EQUAL(s.RefCount(), 0);
+  JNU_UT_EQUAL(destroyed, 1);
+}
+// Test of biased reference count
+void RefTest::TestBiased() {
+  destroyed = 0;
+  jnu::LocalRef<BiasedObj> a;
+  JNU_UT_CHECK(a.New(&jnu::memory::MM_BUILDIN, 8, 7));
+  JNU_UT_CHECK(a->IsOwner());
+  JNU_UT_EQUAL(a->RefCount(), 1);
+  jnu::LocalRef<BiasedObj> b = a;  // Local copy
+  JNU_UT_EQUAL(a->RefCount(), 2);
+  // Share with other thread, local references are
+  // released first
+  jnu::Ref<BiasedObj> s = a.Share();
+  bool owner = true;
+  std::thread t([&owner](jnu::Ref<BiasedObj> r) {
+    owner = r->IsOwner();
+  }, std::move(s));
+  a.Reset();
+  b.Reset();
+  JNU_UT_CHECK(!s);
+  t.join();
+  JNU_UT_CHECK(!owner);
+  JNU_UT_EQUAL(destroyed, 1);
+  // Shared references are released first
+  JNU_UT_CHECK(a.New(&jnu::memory::MM_BUILDIN, 8, 9));
+  s = a.Share();
+  t = std::thread([](jnu::Ref<BiasedObj> r) {
+    jnu::Ref<BiasedObj> c(r);
+  }, std::move(s));
+  t.join();
+  JNU_UT_EQUAL(destroyed, 1);
+  JNU_UT_EQUAL(a->RefCount(), 1);
+  a.Reset();
+  JNU_UT_EQUAL(destroyed, 2);
+  // Local reference created again from a shared one
+  jnu::Ref<BiasedObj> r;
+  JNU_UT_CHECK(r.New(&jnu::memory::MM_BUILDIN, 8, 11));
+  a = jnu::LocalRef<BiasedObj>(r);
+  a.Reset();
+  JNU_UT_EQUAL(destroyed, 2);
+  r.Reset();
+  JNU_UT_EQUAL(destroyed, 3);
+}
+// Main test entry
+void RefTest::Test() {
+  TestRef();  // Atomic reference count
+  TestBiased();  // Biased reference count
+}
@@ -0,0 +1,83 @@
+// By JNI
+// Implementation of thread pool tests
+
+#include "jnu_thread_pool_test.h"
+
+using namespace jnu_test;
+
+// Task function with stored argument
+static void AddArg(jnu::atomic::Base<int>*& sum, int v) {
+  sum->AddFetch(v);
+}
+// Task object with member function
+struct Adder {
+  void Add() {
+    m_sum->AddFetch(20);
+  }
+  jnu::atomic::Base<int>* m_sum;  // Sum to add
+};
+// Recursive fibonacci, sub tasks are submitted by workers
+static void Fib(jnu::ThreadPool& p, int n, long& r) {
+  if (n < 12) {  // Small enough, run serially
+    r = n < 2 ? n : 0;
+    long a = 0, b = 1;
+    for (int i = 1; i < n; ++i) {
+      r = a + b;
+      a = b;
+      b = r;
+    }
+    return;
+  }
+  long x = 0, y = 0;
+  jnu::ThreadPool::Group g;
+  p.Submit(g, [&p, n, &x]() { Fib(p, n - 1, x); });
+  Fib(p, n - 2, y);
+  p.Wait(g);  // Help running tasks while waiting
+  r = x + y;
+}
+// Main test entry
+void ThreadPoolTest::Test() {
+  jnu::atomic::Base<int> sum(0);  // Sum of task results
+  {
+    jnu::ThreadPool p(4, 64);
+    JNU_UT_EQUAL(p.Size(), 4);
+    JNU_UT_EQUAL(p.Capacity(), 64);
+    JNU_UT_EQUAL(p.WorkerIndex(), jnu::ThreadPool::NPOS);
+    // More tasks than slots, the rest run in calling thread
+    jnu::ThreadPool::Group g;
+    for (int i = 1; i <= 1000; ++i) {
+      p.Submit(g, [&sum, i]() { sum.AddFetch(i); });
+    }
+    p.Wait(g);
+    JNU_UT_CHECK(g.IsDone());
+    JNU_UT_EQUAL(sum.Load(), 500500);
+    // Task knows its worker (wait without helping)
+    jnu::atomic::Base<size_t> index(jnu::ThreadPool::NPOS);
+    p.Submit(g, [&p, &index]() { index = p.WorkerIndex(); });
+    while (!g.IsDone()) {
+      std::this_thread::yield();
+    }
+    JNU_UT_CHECK(index.Load() < p.Size());
+    // Callback wraps as task
+    jnu::FuncArg<void, jnu::atomic::Base<int>*, int> fa(AddArg, &sum);
+    p.Submit(g, [fa]() mutable { fa(10); });
+    Adder adder = {&sum};
+    jnu::FuncObj<Adder*, void> fo(&adder, &Adder::Add);
+    p.Submit(g, jnu::Callback<jnu::FuncObj<Adder*, void>>(fo));
+    p.Wait(g);
+    JNU_UT_EQUAL(sum.Load(), 500530);
+    // Nested tasks submitted by workers are stolen by others
+    long r = 0;
+    Fib(p, 25, r);
+    JNU_UT_EQUAL(r, 75025);
+    // Pending tasks are completed by deconstructor
+    sum = 0;
+    for (int i = 0; i < 50; ++i) {
+      p.Submit([&sum]() {
+        std::this_thread::yield();
+        sum.AddFetch(1);
+      });
+    }
+  }
+  JNU_UT_EQUAL(sum.Load(), 50);
+}
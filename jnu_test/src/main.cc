@@ -8,6 +8,21 @@
 #include "jnu_callback_test.h"
 #include "jnu_array_test.h"
 #include "jnu_array_set_test.h"
+#include "jnu_atomic_test.h"
+#include "jnu_bitset_test.h"
+#include "jnu_ref_test.h"
+#include "jnu_atomic_list_test.h"
+#include "jnu_queue_test.h"
+#include "jnu_thread_pool_test.h"
+#include "jnu_parallel_test.h"
+#include "jnu_eytzinger_test.h"
+#include "jnu_array_set_algo_test.h"
+#include "jnu_lsm_array_set_test.h"
+#include "jnu_btree_test.h"
+#include "jnu_pgm_test.h"
+#include "jnu_bloom_test.h"
+#include "jnu_compressed_array_set_test.h"
+#include "jnu_frozen_map_test.h"
 
 using namespace jnu_test;
 
@@ -20,6 +35,22 @@ class JnuTest : public jnu::TestCase{
     Run<CallbackTest>("callback");  // Callback test
     Run<ArrayTest>("array");  // Array test
     Run<ArraySetTest>("array set");  // Array set test
+    Run<AtomicTest>("atomic");  // Atomic test
+    Run<BitsetTest>("bitset");  // Atomic bitset test
+    Run<RefTest>("reference");  // Reference counting test
+    Run<AtomicListTest>("atomic list");  // Concurrent list test
+    Run<QueueTest>("queue");  // Bounded queue test
+    Run<ThreadPoolTest>("thread pool");  // Thread pool test
+    Run<ParallelTest>("parallel");  // Parallel algorithm test
+    Run<EytzingerTest>("eytzinger");  // Eytzinger search index test
+    Run<ArraySetAlgoTest>("array set algo");  // Set algebra test
+    Run<LsmArraySetTest>("lsm array set");  // Log-structured set test
+    Run<BTreeTest>("btree");  // B+tree test
+    Run<PgmTest>("pgm");  // Learned search index test
+    Run<BloomTest>("bloom");  // Bloom filter test
+    // Compressed sorted set test
+    Run<CompressedArraySetTest>("compressed array set");
+    Run<FrozenMapTest>("frozen map");  // Perfect hash index test
   }
 };
 // Main function